@@ -0,0 +1,817 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "Bitboard.h"
+#include "BoardGeometry.h"
+#include "Constants.h"
+#include "Grid2.h"
+#include "MoveHistoryEntry.h"
+#include "RandomStream.h"
+#include "Symmetry.h"
+
+namespace BeitaGo {
+	/**
+	 * Stores the board state (and in turn the overall game state) for boards of a given geometry.
+	 * Board wraps this for any size; search and playout code that knows its size can use a
+	 * FixedBoard directly so every loop bound is a constant.
+	 *
+	 * Each point has a padded index of (y + 1) * stride + (x + 1), where the stride is one more than
+	 * the width. This leaves a guard column between rows and a guard row above and below the board,
+	 * so a point's neighbours are always 1 and the stride away without wrapping around an edge.
+	 * Stones are held both in bitboards, where shifting by those offsets moves every point at once,
+	 * and in a flat array of tiles where the guard points are marked as Edge, so walking neighbours
+	 * never needs a bounds check.
+	 *
+	 * Each group is a circular list of its stones, named by one representative stone that also
+	 * holds the group's size and liberty count. Merging, capturing and listing a group only walk
+	 * the stones involved.
+	 *
+	 * The implementation is compiled for FixedGeometry<9>, FixedGeometry<13>, FixedGeometry<19>
+	 * and DynamicGeometry.
+	 */
+	template <typename Geometry>
+	class BasicBoard {
+		public:
+		/**
+		 * The number of padded points this board stores.
+		 */
+		static constexpr int MAX_POINTS = Geometry::MAX_POINTS;
+
+		/**
+		 * A bitboard just big enough for this board.
+		 */
+		using PointSet = BasicBitboard<(MAX_POINTS + 63) / 64>;
+
+		/**
+		 * Constructs a new board with the given geometry.
+		 * @param geometry
+		 */
+		explicit BasicBoard(const Geometry& geometry = Geometry());
+
+		/**
+		 * Constructs a new board with the given dimensions. This throws if the geometry can't
+		 * hold them.
+		 * @param dimensions
+		 */
+		explicit BasicBoard(const Grid2& dimensions);
+
+		/**
+		 * Returns this board's dimensions.
+		 * @return
+		 */
+		Grid2 GetDimensions() const;
+
+		/**
+		 * Returns the tile placed at a given position. If the position is out of the board's range,
+		 * it just returns None.
+		 * @param position
+		 * @return
+		 */
+		Color GetTile(const Grid2& position) const;
+
+		/**
+		 * Returns the Color of whoever's turn it is.
+		 * @return
+		 */
+		Color GetWhoseTurn() const;
+
+		/**
+		 * Returns the current turn count. Games start at turn 1, and increment turn after each
+		 * piece (so the player who goes first will play on odd-numbered turns, etc.).
+		 * @return
+		 */
+		int GetTurnCount() const;
+
+		/**
+		 * Returns whether the game is currently over.
+		 * @return
+		 */
+		bool IsGameOver() const;
+
+		/**
+		 * Places a piece at the given space with the given color. This throws if the move would be
+		 * invalid. When you act a decision, run it by IsMoveValid first.
+		 * @param position
+		 * @param color
+		 */
+		void PlacePiece(const Grid2& position, Color color);
+
+		/**
+		 * Returns whether placing a piece at the given position with the given color would be
+		 * valid or not.
+		 * @param position
+		 * @param color
+		 * @return
+		 */
+		bool IsMoveValid(const Grid2& position, Color color) const;
+
+		/**
+		 * Returns whether placing a piece at the given position with the given color would
+		 * immediately retake a ko. Passing or a position off the board never does.
+		 * @param position
+		 * @param color
+		 * @return
+		 */
+		bool IsMoveKo(const Grid2& position, Color color) const;
+
+		/**
+		 * Returns whether placing a piece at the given position with the given color would repeat
+		 * an earlier position of this game (positional superko). Passing or a position off the
+		 * board never does.
+		 * @param position
+		 * @param color
+		 * @return
+		 */
+		bool IsMoveSuperko(const Grid2& position, Color color) const;
+
+		/**
+		 * Returns whether placing a piece at the given position with the given color would be
+		 * a suicide play or not. Passing or a position off the board never is.
+		 * @param position
+		 * @param color
+		 * @return
+		 */
+		bool IsMoveSuicidePlay(const Grid2& position, Color color) const;
+
+		/**
+		 * Returns whether an empty position is a true eye of the given color: every neighbour is
+		 * that color, and the enemy holds at most one diagonal, or none on the edge. Filling one of
+		 * your own true eyes is never a good move.
+		 * @param position
+		 * @param color
+		 * @return
+		 */
+		bool IsEye(const Grid2& position, Color color) const;
+
+		/**
+		 * Returns whether the given position is within the grounds of the board.
+		 * @param position
+		 * @return
+		 */
+		bool IsWithinBoard(const Grid2& position) const;
+
+		/**
+		 * Returns the moves that a specific color can place on this turn.
+		 * @param color
+		 * @return
+		 */
+		std::vector<Grid2> GetValidMoves(const Color& color) const;
+
+		/**
+		 * Returns every point a color can play on this turn, as a bitboard with the bit of (x, y)
+		 * at Point::At(x, y, width).Index(). Passing is always legal and isn't included. This is
+		 * worked out for the whole board at once with a few operations per word, so it's the
+		 * cheapest way to mask a network's outputs or expand a search node.
+		 * @param color
+		 * @return
+		 */
+		Bitboard LegalMask(Color color) const;
+
+		/**
+		 * Returns the stones of a color as a bitboard laid out like LegalMask. This copies whole
+		 * rows of the board's own bitboard, so it's the cheapest way to read every stone.
+		 * @param color
+		 * @return
+		 */
+		Bitboard GetStoneMask(Color color) const;
+
+		/**
+		 * Returns one of the feature planes a network can take as input, laid out like LegalMask.
+		 * The liberty planes are kept up to date as moves are played, and the capture planes
+		 * only look at the groups in atari, so every plane is a handful of bitboard operations.
+		 * @param plane
+		 * @return
+		 */
+		Bitboard GetFeaturePlane(FeaturePlane plane) const;
+
+		/**
+		 * Returns a uniformly random valid move for the given color other than passing, or PASS
+		 * if there isn't one. Random empty points are tried until one is legal, so this doesn't
+		 * look at the whole board unless almost every empty point is illegal.
+		 * @param color
+		 * @param random
+		 * @return
+		 */
+		template <typename Random>
+		Grid2 GetRandomValidMove(Color color, Random& random) const {
+			// Each draw is uniform over the empty points, so the first legal one is uniform over
+			// the legal points.
+			for (int attempt = 0; attempt < RANDOM_MOVE_ATTEMPTS && _numEmpty > 0; ++attempt) {
+				int index = _emptyPoints[RandomBelow(random, _numEmpty)];
+				if (IsLegal(index, color)) {
+					return ToGrid2(index);
+				}
+			}
+
+			// Too many misses means most points are illegal, so list the legal ones instead.
+			int legal[MAX_POINTS];
+			int numLegal = 0;
+			for (int i = 0; i < _numEmpty; ++i) {
+				if (IsLegal(_emptyPoints[i], color)) {
+					legal[numLegal++] = _emptyPoints[i];
+				}
+			}
+			if (numLegal == 0) {
+				return PASS;
+			}
+			return ToGrid2(legal[RandomBelow(random, numLegal)]);
+		}
+
+		/**
+		 * Returns how many points on the board are empty.
+		 * @return
+		 */
+		int GetEmptyCount() const;
+
+		/**
+		 * Gets the current komi for the white player.
+		 * @return
+		 */
+		double GetKomi() const;
+
+		/**
+		 * Sets the current komi for the white player for this board.
+		 * @param komi
+		 * @return
+		 */
+		void SetKomi(double komi);
+
+		/**
+		 * Gets the current score for this board. Positive is in favor of white, negative is in favor of black.
+		 * @return
+		 */
+		double Score() const;
+
+		/**
+		 * Gets the current score using the area method. Positive is in favor of white, negative is in favor of black.
+		 * @return
+		 */
+		double ScoreArea() const;
+
+		/**
+			* Returns how many liberties a tile has, or -1 if the tile is None or off the board.
+			* @param position
+			* @return
+			*/
+		int GetLiberties(const Grid2& position) const;
+
+		/**
+		 * Returns all the tiles that are of the same color and are adjacent to this tile, or
+		 * nothing if this doesn't point to a tile.
+		 * @param position
+		 * @return
+		 */
+		std::vector<Grid2> GetGroup(const Grid2& position) const;
+
+		/**
+		 * Returns how many liberties a group has.
+		 * @param group
+		 * @return
+		 */
+		int GetGroupLiberties(const std::vector<Grid2>& group) const;
+
+		/**
+		 * Returns every group of the given color that is in atari, as a stone of the group paired
+		 * with its last liberty. Groups in atari are tracked as liberties change, so this doesn't
+		 * look at the rest of the board.
+		 * @param color
+		 * @return
+		 */
+		std::vector<std::pair<Grid2, Grid2>> GetAtariGroups(Color color) const;
+
+		/**
+		 * Returns a stone from each enemy group touching the group at a position, or nothing if
+		 * the position is empty. Each group keeps the points around it up to date as moves are
+		 * played, so this doesn't walk the group or fill out from it.
+		 * @param position
+		 * @return
+		 */
+		std::vector<Grid2> GetAdjacentGroups(const Grid2& position) const;
+
+		/**
+		 * Returns how many liberties the groups at two positions have in common, or 0 if either
+		 * position is empty. Together with GetAdjacentGroups, this is what a capturing race
+		 * between two groups turns on.
+		 * @param a
+		 * @param b
+		 * @return
+		 */
+		int GetSharedLiberties(const Grid2& a, const Grid2& b) const;
+
+		/**
+		 * Reads out whether the group at a position can be captured in a ladder. A group in atari
+		 * is read with its owner to move, trying to extend or capture its way out, and a group
+		 * with two liberties is read with the other player to move, trying each atari. Anything
+		 * with more liberties, or a ladder longer than LADDER_MAX_DEPTH moves, counts as escaping.
+		 * The moves are played and taken back on this board, which ends up as it started.
+		 * @param position
+		 * @return
+		 */
+		bool IsLadderCaptured(const Grid2& position);
+
+		/**
+		 * Tells the board that the turn is over.
+		 */
+		void NextTurn();
+
+		/**
+		 * Takes back the last piece placed (or pass), putting back anything it captured and
+		 * restoring whose turn and which turn it was. This only touches the points that the move
+		 * changed. This throws if there are no moves to undo.
+		 */
+		void UndoMove();
+
+		/**
+		 * Returns whether there is a move UndoMove can take back. Moves from before a
+		 * LoadPosition can't be, even though they show up in GetHistory.
+		 * @return
+		 */
+		bool CanUndo() const;
+
+		/**
+		 * Moves the board back the set number of plays. Rewinding further than the start of the
+		 * game stops at the start.
+		 */
+		void RewindBoard(int numTurns);
+
+		/**
+		 * Returns a board that has been rewinded a certain number of moves.
+		 * This is identical to copying the board and rewinding it.
+		 */
+		BasicBoard GetPreviousState(int numTurns) const;
+
+		/**
+		 * Returns a board layout that has been rewinded a certain number of moves.
+		 * Unlike the other function, this function doesn't copy any other details, which is useful
+		 * for creating screens for the history. This is in [x][y] format. It only walks back
+		 * through the moves being rewound, and stops at the start of the game.
+		 */
+		std::vector<std::vector<Color>> GetPreviousLayout(int numTurns) const;
+
+		/**
+		 * Replaces the game with a position given as a layout in [x][y] format, as if the game
+		 * started there. The ko point is one whoseTurn can't play this turn, or PASS. The recent
+		 * moves show up in GetHistory and IsGameOver, but they can't be undone, and superko
+		 * only looks at positions from here on. The komi is kept. This throws if the layout
+		 * doesn't fit the board or has a group with no liberties.
+		 * @param layout
+		 * @param whoseTurn
+		 * @param turnCount
+		 * @param koPoint
+		 * @param blackPiecesTaken
+		 * @param whitePiecesTaken
+		 * @param recentMoves
+		 */
+		void LoadPosition(const std::vector<std::vector<Color>>& layout, Color whoseTurn, int turnCount, const Grid2& koPoint, int blackPiecesTaken, int whitePiecesTaken, const std::vector<MoveHistoryEntry>& recentMoves);
+
+		/**
+		 * Returns the history of all the moves played by the game.
+		 */
+		std::vector<MoveHistoryEntry> GetHistory() const;
+
+		/**
+		 * Returns how many passes in a row the game so far ends with. Only those passes are
+		 * looked at, so unlike counting them in GetHistory this doesn't copy anything.
+		 * @return
+		 */
+		int GetConsecutivePasses() const;
+
+		/**
+		 * Returns a Zobrist hash of the current position, including whose turn it is. It is
+		 * updated as pieces are placed, so reading it is free.
+		 * @return
+		 */
+		uint64_t GetHash() const;
+
+		/**
+		 * Returns a Zobrist hash of just the stones on the board. This is what positional superko
+		 * compares.
+		 * @return
+		 */
+		uint64_t GetPositionHash() const;
+
+		/**
+		 * Returns the position hash the board would have after a transform (see Symmetry.h).
+		 * Transform 0 is GetPositionHash. All of them are updated as stones come and go.
+		 * @param transform
+		 * @return
+		 */
+		uint64_t GetSymmetryHash(int transform) const;
+
+		/**
+		 * Returns a hash that is the same for every rotation and reflection of this position, as
+		 * long as it fits the same board, including whose turn it is. This is the smallest
+		 * GetSymmetryHash of the transforms that map the board onto itself.
+		 * @return
+		 */
+		uint64_t GetCanonicalHash() const;
+
+		/**
+		 * Returns the transform whose hash GetCanonicalHash uses. Moves on this board can be
+		 * mapped into the canonical position with TransformPoint, and back out with
+		 * InverseTransform.
+		 * @return
+		 */
+		int GetCanonicalTransform() const;
+
+		/**
+		 * Returns the point that can't be played this turn because it would retake a ko, or PASS
+		 * if there isn't one.
+		 * @return
+		 */
+		Grid2 GetKoPoint() const;
+
+		/**
+		 * Returns the number of pieces the black player has captured.
+		 */
+		int GetBlackPiecesTaken() const;
+
+		/**
+		 * Returns the number of pieces the white player has captured.
+		 */
+		int GetWhitePiecesTaken() const;
+
+		/**
+		 * Returns the geometry this board was made with.
+		 * @return
+		 */
+		const Geometry& GetGeometry() const;
+
+		private:
+		/**
+		 * Everything needed to take back one move that isn't already on the board.
+		 */
+		struct UndoEntry {
+			int index; // The padded index played, or -1 for a pass.
+			Color color;
+			int capturesBegin; // Where this move's captures start in _capturedStones.
+			uint64_t hash;
+			int koPoint;
+			Color koColor;
+			Color whoseTurn;
+			int turnCount;
+		};
+
+		/**
+		 * How many random empty points GetRandomValidMove tries before listing the legal ones.
+		 */
+		static constexpr int RANDOM_MOVE_ATTEMPTS = 8;
+
+		/**
+		 * The most moves IsLadderCaptured reads ahead. This is enough to run a ladder across the
+		 * largest board.
+		 */
+		static constexpr int LADDER_MAX_DEPTH = 200;
+
+		/**
+		 * The size of the filter that lets most superko checks skip searching the history.
+		 */
+		static constexpr int POSITION_FILTER_WORDS = 64;
+
+		/**
+		 * Returns the bit of the superko filter that a position hash maps to.
+		 * @param positionHash
+		 * @return
+		 */
+		static int PositionFilterBit(uint64_t positionHash);
+
+		/**
+		 * Records the current position as seen for superko.
+		 */
+		void RecordPosition();
+
+		/**
+		 * Returns the padded index of a position on the board.
+		 * @param position
+		 * @return
+		 */
+		int ToIndex(const Grid2& position) const;
+
+		/**
+		 * Returns the position of a padded index on the board.
+		 * @param index
+		 * @return
+		 */
+		Grid2 ToGrid2(int index) const;
+
+		/**
+		 * Runs a function on the padded index of each direct neighbour of a point, including guard
+		 * points. This is inlined into the caller, so it is cheap enough for the innermost loops.
+		 * @param index
+		 * @param f
+		 */
+		template <typename F>
+		void ForEachNeighbor(int index, F f) const {
+			const std::array<int, 4>& offsets = _geometry.NeighborOffsets();
+			f(index + offsets[0]);
+			f(index + offsets[1]);
+			f(index + offsets[2]);
+			f(index + offsets[3]);
+		}
+
+		/**
+		 * Returns the bitboard holding the stones of the given color.
+		 * @param color
+		 * @return
+		 */
+		PointSet& Stones(Color color);
+
+		/**
+		 * Returns the bitboard holding the stones of the given color.
+		 * @param color
+		 * @return
+		 */
+		const PointSet& Stones(Color color) const;
+
+		/**
+		 * Returns the number of stones of the given color on the board.
+		 * @param color
+		 * @return
+		 */
+		int& StoneCount(Color color);
+
+		/**
+		 * Returns a bitboard of every empty point on the board.
+		 * @return
+		 */
+		PointSet Empty() const;
+
+		/**
+		 * Adds a point that has just become empty to the empty point list.
+		 * @param index
+		 */
+		void AddEmpty(int index);
+
+		/**
+		 * Removes a point that has just been filled from the empty point list.
+		 * @param index
+		 */
+		void RemoveEmpty(int index);
+
+		/**
+		 * Returns whether the given color can play at an on-board padded index.
+		 * @param index
+		 * @param color
+		 * @return
+		 */
+		bool IsLegal(int index, Color color) const;
+
+		/**
+		 * Returns whether playing at an empty padded index would retake a ko.
+		 * @param index
+		 * @param color
+		 * @return
+		 */
+		bool IsKo(int index, Color color) const;
+
+		/**
+		 * Returns whether playing at an empty padded index would repeat an earlier position.
+		 * @param index
+		 * @param color
+		 * @return
+		 */
+		bool IsSuperko(int index, Color color) const;
+
+		/**
+		 * Returns whether a position hash has been seen before in this game.
+		 * @param positionHash
+		 * @return
+		 */
+		bool IsPositionSeen(uint64_t positionHash) const;
+
+		/**
+		 * Returns whether playing at an empty padded index would be suicide.
+		 * @param index
+		 * @param color
+		 * @return
+		 */
+		bool IsSuicide(int index, Color color) const;
+
+		/**
+		 * Adds or removes a stone from every symmetry hash.
+		 * @param index
+		 * @param color
+		 */
+		void ToggleSymmetryKeys(int index, Color color);
+
+		/**
+		 * Returns whether a padded index is a true eye of the given color. See IsEye.
+		 * @param index
+		 * @param color
+		 * @return
+		 */
+		bool IsTrueEye(int index, Color color) const;
+
+		/**
+		 * Returns the padded indices the given color can play at. A point is legal when it's empty,
+		 * isn't the ko point, and either has an empty neighbour, joins a friendly group that has
+		 * another liberty or takes the last liberty of an enemy group, which are all bitwise
+		 * operations over the stones, liberties and groups in atari. Only the points left then
+		 * have to be checked for superko one at a time.
+		 * @param color
+		 * @return
+		 */
+		PointSet LegalPoints(Color color) const;
+
+		/**
+		 * Returns a set of padded points as a bitboard in Point order, as LegalMask describes.
+		 * @param points
+		 * @return
+		 */
+		Bitboard ToPointOrder(const PointSet& points) const;
+
+		/**
+		 * Returns the position hash after the given color plays at a padded index, including any
+		 * stones it would capture.
+		 * @param index
+		 * @param color
+		 * @return
+		 */
+		uint64_t PositionHashAfter(int index, Color color) const;
+
+		/**
+		 * Joins two groups of the same color into one and returns the representative of the
+		 * result. Liberties are not updated.
+		 * @param a
+		 * @param b
+		 * @return
+		 */
+		int MergeGroups(int a, int b);
+
+		/**
+		 * Works out the liberties of a group from scratch by walking its stones.
+		 * @param group
+		 * @return
+		 */
+		PointSet FindLibertySet(int group) const;
+
+		/**
+		 * Returns how many liberties a group has. This is always the size of its liberty set,
+		 * since only the functions below change either.
+		 * @param group
+		 * @return
+		 */
+		int LibertyCount(int group) const;
+
+		/**
+		 * Replaces the liberties of a group.
+		 * @param group
+		 * @param liberties
+		 */
+		void SetLiberties(int group, const PointSet& liberties);
+
+		/**
+		 * Gives a group a liberty at a padded index. Adding one it already has does nothing.
+		 * @param group
+		 * @param index
+		 */
+		void AddLiberty(int group, int index);
+
+		/**
+		 * Takes a liberty at a padded index away from a group. Taking one it doesn't have does
+		 * nothing.
+		 * @param group
+		 * @param index
+		 */
+		void RemoveLiberty(int group, int index);
+
+		/**
+		 * Keeps _atari and _twoLiberties in step with a group whose liberties just changed, and
+		 * _oneLibertyStones and _twoLibertyStones with them.
+		 * @param group
+		 */
+		void UpdateAtari(int group);
+
+		/**
+		 * Moves some stones of a group onto the liberty plane its liberties put it on.
+		 * @param group
+		 * @param stones
+		 */
+		void UpdateLibertyPlanes(int group, const PointSet& stones);
+
+		/**
+		 * Writes up to max distinct liberties of a group into liberties and returns how many it
+		 * found.
+		 * @param group
+		 * @param liberties
+		 * @param max
+		 * @return
+		 */
+		int FindLiberties(int group, int* liberties, int max) const;
+
+		/**
+		 * Runs a function on the representative of every enemy group touching a group, once
+		 * each.
+		 * @param group
+		 * @param f
+		 */
+		template <typename F>
+		void ForEachAdjacentGroup(int group, F f) const;
+
+		/**
+		 * Reads a ladder with the owner of the group in atari at stone to move. Returns whether
+		 * every escape fails.
+		 * @param stone
+		 * @param depth
+		 * @return
+		 */
+		bool LadderDefend(int stone, int depth);
+
+		/**
+		 * Reads a ladder against the group at stone with the other player to move. Returns
+		 * whether some atari captures it.
+		 * @param stone
+		 * @param depth
+		 * @return
+		 */
+		bool LadderAttack(int stone, int depth);
+
+		/**
+		 * Forms a new group out of the seed stone and every stone of the same color connected to
+		 * it that isn't already in a group, and finds its outline. Returns the representative.
+		 * Liberties are not updated.
+		 * @param seed
+		 * @param color
+		 * @return
+		 */
+		int BuildGroup(int seed, Color color);
+
+		/**
+		 * Removes every stone of a group from the board, giving liberties back to the groups
+		 * around it, and records them in the undo log. Returns how many stones were removed.
+		 * @param group
+		 * @param color
+		 * @return
+		 */
+		int RemoveGroup(int group, Color color);
+
+		/**
+		 * Converts a pair of stone bitboards into a layout in [x][y] format.
+		 * @param black
+		 * @param white
+		 * @return
+		 */
+		std::vector<std::vector<Color>> ToLayout(const PointSet& black, const PointSet& white) const;
+
+		Geometry _geometry;
+		std::array<Tile, MAX_POINTS> _tiles; // Every padded point, with Edge on the guard points.
+		PointSet _onBoard;
+		PointSet _black;
+		PointSet _white;
+		std::array<int, MAX_POINTS> _groupOf; // The representative stone of each point's group, or -1.
+		std::array<int, MAX_POINTS> _nextStone; // Each group's stones form a circular list through this.
+		std::array<int, MAX_POINTS> _groupSize; // Only meaningful for representatives.
+		std::array<PointSet, MAX_POINTS> _liberties; // The empty points next to each group. Only meaningful for representatives.
+		std::array<int, MAX_POINTS> _libertyCount; // The size of each set in _liberties, so reading it is a lookup.
+		std::array<PointSet, MAX_POINTS> _outline; // Every point next to each group, stones or empty. Only meaningful for representatives.
+		PointSet _atari; // The representatives of groups with one liberty.
+		PointSet _twoLiberties; // The representatives of groups with two liberties.
+		PointSet _oneLibertyStones; // Every stone of the groups in _atari.
+		PointSet _twoLibertyStones; // Every stone of the groups in _twoLiberties.
+		std::array<int, MAX_POINTS> _emptyPoints; // The first _numEmpty are the empty points, in no order.
+		std::array<int, MAX_POINTS> _emptyPosition; // Where each empty point sits in _emptyPoints.
+		int _numEmpty;
+		int _blackStones;
+		int _whiteStones;
+		uint64_t _hash;
+		std::array<uint64_t, SYMMETRY_COUNT> _symmetryHashes; // The position hash under each transform.
+		int _koPoint; // The padded index that _koColor can't play this turn, or -1.
+		Color _koColor;
+		std::vector<uint64_t> _positionHashes; // Every position seen this game, kept sorted.
+		BasicBitboard<POSITION_FILTER_WORDS> _positionFilter; // A quick negative check for _positionHashes.
+		std::vector<MoveHistoryEntry> _history;
+		std::vector<UndoEntry> _undoLog;
+		std::vector<int> _capturedStones; // The stones captured by each move in _undoLog, in order.
+
+		Color _whoseTurn;
+		int _blackPiecesTaken;
+		int _whitePiecesTaken;
+		int _turnCount;
+		double _komi;
+	};
+
+	template <typename Geometry>
+	constexpr int BasicBoard<Geometry>::MAX_POINTS;
+
+	template <typename Geometry>
+	constexpr int BasicBoard<Geometry>::LADDER_MAX_DEPTH;
+
+	/**
+	 * A board whose size is fixed at compile time. FixedBoard<9>, FixedBoard<13> and
+	 * FixedBoard<19> are available.
+	 */
+	template <int N>
+	using FixedBoard = BasicBoard<FixedGeometry<N>>;
+
+	extern template class BasicBoard<FixedGeometry<9>>;
+	extern template class BasicBoard<FixedGeometry<13>>;
+	extern template class BasicBoard<FixedGeometry<19>>;
+	extern template class BasicBoard<DynamicGeometry>;
+}
+
+
@@ -0,0 +1,382 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <utility>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#elif defined(__BMI2__)
+#include <immintrin.h>
+#endif
+
+#include "Constants.h"
+
+namespace BeitaGo {
+	/**
+	 * Returns the number of set bits in a word.
+	 * @param word
+	 * @return
+	 */
+	inline int PopCount(uint64_t word) {
+#ifdef _MSC_VER
+		return static_cast<int>(__popcnt64(word));
+#else
+		return __builtin_popcountll(word);
+#endif
+	}
+
+	/**
+	 * Returns the index of the lowest set bit in a word. The word must not be zero.
+	 * @param word
+	 * @return
+	 */
+	inline int LowestBit(uint64_t word) {
+#ifdef _MSC_VER
+		unsigned long index;
+		_BitScanForward64(&index, word);
+		return static_cast<int>(index);
+#else
+		return __builtin_ctzll(word);
+#endif
+	}
+
+	/**
+	 * Returns the index of the nth lowest set bit in a word, counting from 0. The word must have
+	 * more than n bits set.
+	 * @param word
+	 * @param n
+	 * @return
+	 */
+	inline int SelectBit(uint64_t word, int n) {
+#ifdef __BMI2__
+		return LowestBit(_pdep_u64(uint64_t(1) << n, word));
+#else
+		int base = 0;
+		for (int count = PopCount(word & 0xFF); count <= n; count = PopCount(word & 0xFF)) {
+			n -= count;
+			word >>= 8;
+			base += 8;
+		}
+		for (; n > 0; --n) {
+			word &= word - 1;
+		}
+		return base + LowestBit(word);
+#endif
+	}
+
+	/**
+	 * A fixed-size set of bits, one per point of a board. The bit order follows the board's padded
+	 * point indices, so shifting a whole bitboard up or down moves every point in it by the same
+	 * offset on the board. This is what lets neighbours, groups and liberties be computed for all
+	 * points at once.
+	 */
+	template <int Words>
+	class BasicBitboard {
+		public:
+		/**
+		 * The number of 64-bit words this bitboard holds.
+		 */
+		static constexpr int WORDS = Words;
+
+		/**
+		 * The number of bits this bitboard holds.
+		 */
+		static constexpr int BITS = Words * 64;
+
+		/**
+		 * Constructs an empty bitboard.
+		 */
+		BasicBitboard() : _words() {}
+
+		/**
+		 * Returns whether the given bit is set.
+		 * @param index
+		 * @return
+		 */
+		bool Test(int index) const {
+			return (_words[index >> 6] >> (index & 63)) & 1;
+		}
+
+		/**
+		 * Sets the given bit.
+		 * @param index
+		 */
+		void Set(int index) {
+			_words[index >> 6] |= uint64_t(1) << (index & 63);
+		}
+
+		/**
+		 * Clears the given bit.
+		 * @param index
+		 */
+		void Reset(int index) {
+			_words[index >> 6] &= ~(uint64_t(1) << (index & 63));
+		}
+
+		/**
+		 * Returns whether any bit is set.
+		 * @return
+		 */
+		bool Any() const {
+			uint64_t any = 0;
+			for (int i = 0; i < Words; ++i) {
+				any |= _words[i];
+			}
+			return any != 0;
+		}
+
+		/**
+		 * Returns whether no bit is set.
+		 * @return
+		 */
+		bool None() const {
+			return !Any();
+		}
+
+		/**
+		 * Returns the number of set bits.
+		 * @return
+		 */
+		int Count() const {
+			int count = 0;
+			for (int i = 0; i < Words; ++i) {
+				count += PopCount(_words[i]);
+			}
+			return count;
+		}
+
+		/**
+		 * Returns the index of the lowest set bit, or -1 if there isn't one.
+		 * @return
+		 */
+		int First() const {
+			for (int i = 0; i < Words; ++i) {
+				if (_words[i] != 0) {
+					return i * 64 + LowestBit(_words[i]);
+				}
+			}
+			return -1;
+		}
+
+		/**
+		 * Runs a function on the index of every set bit, from lowest to highest.
+		 * @param f
+		 */
+		template <typename F>
+		void ForEach(F f) const {
+			for (int i = 0; i < Words; ++i) {
+				uint64_t word = _words[i];
+				while (word != 0) {
+					f(i * 64 + LowestBit(word));
+					word &= word - 1;
+				}
+			}
+		}
+
+		/**
+		 * Returns count bits starting at the given index, as the low bits of a word. count must
+		 * be between 1 and 57.
+		 * @param index
+		 * @param count
+		 * @return
+		 */
+		uint64_t GetBits(int index, int count) const {
+			int word = index >> 6;
+			int shift = index & 63;
+			uint64_t bits = _words[word] >> shift;
+			if (shift + count > 64 && word + 1 < Words) {
+				bits |= _words[word + 1] << (64 - shift);
+			}
+			return bits & ((uint64_t(1) << count) - 1);
+		}
+
+		/**
+		 * Sets the bits starting at the given index that are set in the low count bits of a
+		 * word. count must be between 1 and 57.
+		 * @param index
+		 * @param count
+		 * @param bits
+		 */
+		void OrBits(int index, int count, uint64_t bits) {
+			int word = index >> 6;
+			int shift = index & 63;
+			bits &= (uint64_t(1) << count) - 1;
+			_words[word] |= bits << shift;
+			if (shift + count > 64) {
+				_words[word + 1] |= bits >> (64 - shift);
+			}
+		}
+
+		/**
+		 * Returns a copy of this bitboard with every bit moved n places towards the higher indices.
+		 * Bits moved past the end are lost. n must be between 1 and 63.
+		 * @param n
+		 * @return
+		 */
+		BasicBitboard ShiftUp(int n) const {
+			BasicBitboard b;
+			b._words[0] = _words[0] << n;
+			for (int i = 1; i < Words; ++i) {
+				b._words[i] = (_words[i] << n) | (_words[i - 1] >> (64 - n));
+			}
+			return b;
+		}
+
+		/**
+		 * Returns a copy of this bitboard with every bit moved n places towards the lower indices.
+		 * Bits moved past the start are lost. n must be between 1 and 63.
+		 * @param n
+		 * @return
+		 */
+		BasicBitboard ShiftDown(int n) const {
+			BasicBitboard b;
+			for (int i = 0; i < Words - 1; ++i) {
+				b._words[i] = (_words[i] >> n) | (_words[i + 1] << (64 - n));
+			}
+			b._words[Words - 1] = _words[Words - 1] >> n;
+			return b;
+		}
+
+		/**
+		 * Returns the bits 1 and stride places either side of every set bit, which on a padded
+		 * board are a point's four neighbours. The stride must be between 1 and 63.
+		 * @param stride
+		 * @return
+		 */
+		BasicBitboard Neighbors(int stride) const {
+			return ShiftUp(1) | ShiftDown(1) | ShiftUp(stride) | ShiftDown(stride);
+		}
+
+		/**
+		 * Returns a copy of this bitboard with every set bit also spread to its neighbours, as
+		 * Neighbors describes.
+		 * @param stride
+		 * @return
+		 */
+		BasicBitboard Dilate(int stride) const {
+			return *this | Neighbors(stride);
+		}
+
+		BasicBitboard& operator&=(const BasicBitboard& o) {
+			for (int i = 0; i < Words; ++i) {
+				_words[i] &= o._words[i];
+			}
+			return *this;
+		}
+
+		BasicBitboard& operator|=(const BasicBitboard& o) {
+			for (int i = 0; i < Words; ++i) {
+				_words[i] |= o._words[i];
+			}
+			return *this;
+		}
+
+		BasicBitboard& operator^=(const BasicBitboard& o) {
+			for (int i = 0; i < Words; ++i) {
+				_words[i] ^= o._words[i];
+			}
+			return *this;
+		}
+
+		BasicBitboard operator&(const BasicBitboard& o) const {
+			return BasicBitboard(*this) &= o;
+		}
+
+		BasicBitboard operator|(const BasicBitboard& o) const {
+			return BasicBitboard(*this) |= o;
+		}
+
+		BasicBitboard operator^(const BasicBitboard& o) const {
+			return BasicBitboard(*this) ^= o;
+		}
+
+		BasicBitboard operator~() const {
+			BasicBitboard b;
+			for (int i = 0; i < Words; ++i) {
+				b._words[i] = ~_words[i];
+			}
+			return b;
+		}
+
+		bool operator==(const BasicBitboard& o) const {
+			uint64_t diff = 0;
+			for (int i = 0; i < Words; ++i) {
+				diff |= _words[i] ^ o._words[i];
+			}
+			return diff == 0;
+		}
+
+		bool operator!=(const BasicBitboard& o) const {
+			return !(*this == o);
+		}
+
+		/**
+		 * Returns the raw word at the given index.
+		 * @param i
+		 * @return
+		 */
+		uint64_t Word(int i) const {
+			return _words[i];
+		}
+
+		/**
+		 * Returns a modifiable reference to the raw word at the given index.
+		 * @param i
+		 * @return
+		 */
+		uint64_t& Word(int i) {
+			return _words[i];
+		}
+
+		private:
+		std::array<uint64_t, Words> _words;
+	};
+
+	/**
+	 * Returns the seeds together with every point of through that can be reached from them by
+	 * stepping between neighbours inside through. This is a flood fill that handles every point
+	 * of the frontier at once.
+	 * @param seeds
+	 * @param through
+	 * @param stride
+	 * @return
+	 */
+	template <int Words>
+	BasicBitboard<Words> FloodFill(const BasicBitboard<Words>& seeds, const BasicBitboard<Words>& through, int stride) {
+		BasicBitboard<Words> filled = seeds;
+		BasicBitboard<Words> previous;
+		do {
+			previous = filled;
+			filled |= filled.Dilate(stride) & through;
+		} while (filled != previous);
+		return filled;
+	}
+
+	/**
+	 * Returns how many empty points only black can reach and how many only white can reach,
+	 * which are the points area scoring gives each of them.
+	 * @param black
+	 * @param white
+	 * @param empty
+	 * @param stride
+	 * @return
+	 */
+	template <int Words>
+	std::pair<int, int> CountTerritory(const BasicBitboard<Words>& black, const BasicBitboard<Words>& white, const BasicBitboard<Words>& empty, int stride) {
+		BasicBitboard<Words> blackReach = FloodFill(black, empty, stride) & empty;
+		BasicBitboard<Words> whiteReach = FloodFill(white, empty, stride) & empty;
+		return std::make_pair((blackReach & ~whiteReach).Count(), (whiteReach & ~blackReach).Count());
+	}
+
+	/**
+	 * The number of words needed to hold every padded point of the largest supported board. Boards
+	 * are padded with one guard column and a guard row above and below (see Board).
+	 */
+	constexpr int BOARD_BITBOARD_WORDS = (MAX_PADDED_POINTS + 63) / 64;
+
+	/**
+	 * A bitboard that can hold any supported board.
+	 */
+	using Bitboard = BasicBitboard<BOARD_BITBOARD_WORDS>;
+}
@@ -1,24 +1,42 @@
 #pragma once
 
+#include <cstdint>
 #include <functional>
+#include <memory>
+#include <utility>
 #include <vector>
 
+#include "Bitboard.h"
 #include "Constants.h"
 #include "Grid2.h"
 #include "MoveHistoryEntry.h"
+#include "RandomStream.h"
+#include "Symmetry.h"
 
 namespace BeitaGo {
 	/**
 	 * Stores the board state (and in turn the overall game state).
+	 *
+	 * This is the interface the engine, GTP and the UIs use for a board of any size. The work is
+	 * done by a BasicBoard underneath, which is a FixedBoard for 9x9, 13x13 and 19x19 boards so
+	 * those get the compile-time specialised code. Code that knows its board size up front can
+	 * use a FixedBoard directly and skip this layer.
 	 */
 	class Board {
 		public:
 		/**
-		 * Constructs a new board with the given dimensions.
+		 * Constructs a new board with the given dimensions. This throws if either dimension is not
+		 * between 1 and MAX_BOARD_SIZE.
 		 * @param dimensions
 		 */
 		Board(const Grid2& dimensions);
 
+		Board(const Board& other);
+		Board(Board&& other);
+		Board& operator=(const Board& other);
+		Board& operator=(Board&& other);
+		~Board();
+
 		/**
 		 * Returns this board's dimensions.
 		 * @return
@@ -69,15 +87,44 @@ namespace BeitaGo {
 		 */
 		bool IsMoveValid(const Grid2& position, Color color) const;
 
+		/**
+		 * Returns whether placing a piece at the given position with the given color would
+		 * immediately retake a ko. Passing or a position off the board never does.
+		 * @param position
+		 * @param color
+		 * @return
+		 */
+		bool IsMoveKo(const Grid2& position, Color color) const;
+
+		/**
+		 * Returns whether placing a piece at the given position with the given color would repeat
+		 * an earlier position of this game (positional superko). Passing or a position off the
+		 * board never does.
+		 * @param position
+		 * @param color
+		 * @return
+		 */
+		bool IsMoveSuperko(const Grid2& position, Color color) const;
+
 		/**
 		 * Returns whether placing a piece at the given position with the given color would be
-		 * a suicide play or not.
+		 * a suicide play or not. Passing or a position off the board never is.
 		 * @param position
 		 * @param color
 		 * @return
 		 */
 		bool IsMoveSuicidePlay(const Grid2& position, Color color) const;
 
+		/**
+		 * Returns whether an empty position is a true eye of the given color: every neighbour is
+		 * that color, and the enemy holds at most one diagonal, or none on the edge. Filling one of
+		 * your own true eyes is never a good move.
+		 * @param position
+		 * @param color
+		 * @return
+		 */
+		bool IsEye(const Grid2& position, Color color) const;
+
 		/**
 		 * Returns whether the given position is within the grounds of the board.
 		 * @param position
@@ -92,6 +139,53 @@ namespace BeitaGo {
 		 */
 		std::vector<Grid2> GetValidMoves(const Color& color) const;
 
+		/**
+		 * Returns every point a color can play on this turn, as a bitboard with the bit of (x, y)
+		 * at Point::At(x, y, width).Index(). Passing is always legal and isn't included. This is
+		 * worked out for the whole board at once, so it's the cheapest way to mask a network's
+		 * outputs or expand a search node.
+		 * @param color
+		 * @return
+		 */
+		Bitboard LegalMask(Color color) const;
+
+		/**
+		 * Returns the stones of a color as a bitboard laid out like LegalMask. This copies whole
+		 * rows of the board's own bitboard, so it's the cheapest way to read every stone.
+		 * @param color
+		 * @return
+		 */
+		Bitboard GetStoneMask(Color color) const;
+
+		/**
+		 * Returns one of the feature planes a network can take as input, laid out like LegalMask.
+		 * Liberty counts come straight from the groups the board keeps up to date as moves are
+		 * played, so every plane is a handful of bitboard operations.
+		 * @param plane
+		 * @return
+		 */
+		Bitboard GetFeaturePlane(FeaturePlane plane) const;
+
+		/**
+		 * Returns a uniformly random valid move for the given color other than passing, or PASS
+		 * if there isn't one. This is much cheaper than picking from GetValidMoves, since it only
+		 * checks the points it draws. Any standard random engine works, and a RandomStream is
+		 * quickest.
+		 * @param color
+		 * @param random
+		 * @return
+		 */
+		template <typename Random>
+		Grid2 GetRandomValidMove(const Color& color, Random& random) const {
+			return RandomValidMove(color, [&random](int n) { return RandomBelow(random, n); });
+		}
+
+		/**
+		 * Returns how many points on the board are empty.
+		 * @return
+		 */
+		int GetEmptyCount() const;
+
 		/**
 		 * Gets the current komi for the white player.
 		 * @return
@@ -139,13 +233,67 @@ namespace BeitaGo {
 		 */
 		int GetGroupLiberties(const std::vector<Grid2>& group) const;
 
+		/**
+		 * Returns every group of the given color that is in atari, as a stone of the group paired
+		 * with its last liberty. Groups in atari are tracked as liberties change, so this doesn't
+		 * look at the rest of the board.
+		 * @param color
+		 * @return
+		 */
+		std::vector<std::pair<Grid2, Grid2>> GetAtariGroups(Color color) const;
+
+		/**
+		 * Returns a stone from each enemy group touching the group at a position, or nothing if
+		 * the position is empty. Each group keeps the points around it up to date as moves are
+		 * played, so this doesn't walk the group or fill out from it.
+		 * @param position
+		 * @return
+		 */
+		std::vector<Grid2> GetAdjacentGroups(const Grid2& position) const;
+
+		/**
+		 * Returns how many liberties the groups at two positions have in common, or 0 if either
+		 * position is empty. Together with GetAdjacentGroups, this is what a capturing race
+		 * between two groups turns on.
+		 * @param a
+		 * @param b
+		 * @return
+		 */
+		int GetSharedLiberties(const Grid2& a, const Grid2& b) const;
+
+		/**
+		 * Reads out whether the group at a position can be captured in a ladder. A group in atari
+		 * is read with its owner to move, trying to extend or capture its way out, and a group
+		 * with two liberties is read with the other player to move, trying each atari. Anything
+		 * with more liberties, or a ladder longer than BasicBoard::LADDER_MAX_DEPTH moves, counts as escaping.
+		 * The moves are played and taken back on this board, which ends up as it started.
+		 * @param position
+		 * @return
+		 */
+		bool IsLadderCaptured(const Grid2& position);
+
 		/**
 		 * Tells the board that the turn is over.
 		 */
 		void NextTurn();
 
 		/**
-		 * Moves the board back the set number of plays.
+		 * Takes back the last piece placed (or pass), putting back anything it captured and
+		 * restoring whose turn and which turn it was. This only touches the points that the move
+		 * changed. This throws if there are no moves to undo.
+		 */
+		void UndoMove();
+
+		/**
+		 * Returns whether there is a move UndoMove can take back. Moves from before a
+		 * LoadPosition can't be, even though they show up in GetHistory.
+		 * @return
+		 */
+		bool CanUndo() const;
+
+		/**
+		 * Moves the board back the set number of plays. Rewinding further than the start of the
+		 * game stops at the start.
 		 */
 		void RewindBoard(int numTurns);
 
@@ -158,15 +306,84 @@ namespace BeitaGo {
 		/**
 		 * Returns a board layout that has been rewinded a certain number of moves.
 		 * Unlike the other function, this function doesn't copy any other details, which is useful
-		 * for creating screens for the history. This is in [x][y] format.
+		 * for creating screens for the history. This is in [x][y] format. It only walks back
+		 * through the moves being rewound, and stops at the start of the game.
 		 */
 		std::vector<std::vector<Color>> GetPreviousLayout(int numTurns) const;
 
+		/**
+		 * Replaces the game with a position given as a layout in [x][y] format, as if the game
+		 * started there. The ko point is one whoseTurn can't play this turn, or PASS. The recent
+		 * moves show up in GetHistory and IsGameOver, but they can't be undone, and superko
+		 * only looks at positions from here on. The komi is kept. This throws if the layout
+		 * doesn't fit the board or has a group with no liberties.
+		 * @param layout
+		 * @param whoseTurn
+		 * @param turnCount
+		 * @param koPoint
+		 * @param blackPiecesTaken
+		 * @param whitePiecesTaken
+		 * @param recentMoves
+		 */
+		void LoadPosition(const std::vector<std::vector<Color>>& layout, Color whoseTurn, int turnCount, const Grid2& koPoint, int blackPiecesTaken, int whitePiecesTaken, const std::vector<MoveHistoryEntry>& recentMoves);
+
 		/**
 		 * Returns the history of all the moves played by the game.
 		 */
 		std::vector<MoveHistoryEntry> GetHistory() const;
 
+		/**
+		 * Returns how many passes in a row the game so far ends with. Only those passes are
+		 * looked at, so unlike counting them in GetHistory this doesn't copy anything.
+		 * @return
+		 */
+		int GetConsecutivePasses() const;
+
+		/**
+		 * Returns a Zobrist hash of the current position, including whose turn it is. It is
+		 * updated as pieces are placed, so reading it is free.
+		 * @return
+		 */
+		uint64_t GetHash() const;
+
+		/**
+		 * Returns a Zobrist hash of just the stones on the board. This is what positional superko
+		 * compares.
+		 * @return
+		 */
+		uint64_t GetPositionHash() const;
+
+		/**
+		 * Returns the position hash the board would have after a transform (see Symmetry.h).
+		 * Transform 0 is GetPositionHash. All of them are updated as stones come and go.
+		 * @param transform
+		 * @return
+		 */
+		uint64_t GetSymmetryHash(int transform) const;
+
+		/**
+		 * Returns a hash that is the same for every rotation and reflection of this position, as
+		 * long as it fits the same board, including whose turn it is. This is the smallest
+		 * GetSymmetryHash of the transforms that map the board onto itself.
+		 * @return
+		 */
+		uint64_t GetCanonicalHash() const;
+
+		/**
+		 * Returns the transform whose hash GetCanonicalHash uses. Moves on this board can be
+		 * mapped into the canonical position with TransformPoint, and back out with
+		 * InverseTransform.
+		 * @return
+		 */
+		int GetCanonicalTransform() const;
+
+		/**
+		 * Returns the point that can't be played this turn because it would retake a ko, or PASS
+		 * if there isn't one.
+		 * @return
+		 */
+		Grid2 GetKoPoint() const;
+
 		/**
 		 * Returns the number of pieces the black player has captured.
 		 */
@@ -179,30 +396,20 @@ namespace BeitaGo {
 
 
 		private:
-		/**
-		 * After placing a move, this clears any possible tiles that can be removed.
-		 */
-		void ClearPossibleTiles(const Grid2& position);
+		class Impl;
+		template <typename B>
+		class ImplFor;
+
+		std::unique_ptr<Impl> _impl;
 
 		/**
-		 * Gets the direct neighbors to this Grid2 and runs a function on each one.
-		 * Automatically culls positions that are outside of the board.
+		 * GetRandomValidMove for any generator, which is passed in as a function returning a
+		 * random number from 0 to n - 1, since the board behind this can't take a template.
+		 * @param color
+		 * @param below
+		 * @return
 		 */
-		inline void Neighbors(const Grid2& g, std::function<void(const Grid2&)> f) const;
-
-		Grid2 _dimensions;
-		std::vector<std::vector<Color>> _tiles;
-		std::vector<std::vector<int>> _groups;
-		std::vector<int> _liberties;
-		std::vector<MoveHistoryEntry> _history;
-		std::vector<std::vector<std::vector<Color>>> _lastMoves;
-
-		Color _whoseTurn;
-		int _blackPiecesTaken;
-		int _whitePiecesTaken;
-		int _turnCount;
-		double _komi;
+		Grid2 RandomValidMove(const Color& color, const std::function<int(int)>& below) const;
 	};
 }
 
-
@@ -0,0 +1,213 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <sstream>
+#include <stdexcept>
+
+#include "Constants.h"
+#include "Grid2.h"
+
+namespace BeitaGo {
+	/**
+	 * What occupies a padded point. The first three values line up with Color, and Edge marks the
+	 * guard points around the board.
+	 */
+	enum class Tile : uint8_t {
+		None,
+		Black,
+		White,
+		Edge
+	};
+
+	/**
+	 * Returns the tile a stone of the given color shows as.
+	 * @param color
+	 * @return
+	 */
+	inline Tile ToTile(Color color) {
+		return static_cast<Tile>(color);
+	}
+
+	/**
+	 * Returns which line from the edge a padded index sits on for a board of the given size, where
+	 * the edge is line 1 and the guard points around the board are line 0. See BasicBoard for how
+	 * points are padded.
+	 * @param index
+	 * @param width
+	 * @param height
+	 * @return
+	 */
+	constexpr int PaddedLine(int index, int width, int height) {
+		int x = index % (width + 1) - 1;
+		int y = index / (width + 1) - 1;
+		if (x < 0 || y < 0 || y >= height) {
+			return 0;
+		}
+		return 1 + std::min(std::min(x, width - 1 - x), std::min(y, height - 1 - y));
+	}
+
+	/**
+	 * The line of every padded point of a board, worked out at compile time.
+	 */
+	template <int Width, int Height>
+	struct LineTable {
+		uint8_t lines[(Height + 2) * (Width + 1) + 1];
+
+		constexpr LineTable() : lines() {
+			for (int i = 0; i < (Height + 2) * (Width + 1) + 1; ++i) {
+				lines[i] = static_cast<uint8_t>(PaddedLine(i, Width, Height));
+			}
+		}
+	};
+
+	/**
+	 * The shape of an N by N board, known at compile time. Every size, offset and edge lookup is a
+	 * constant, so loops over a FixedBoard<N> have fixed bounds the compiler can unroll.
+	 */
+	template <int N>
+	class FixedGeometry {
+		public:
+		static_assert(N >= 1 && N <= MAX_BOARD_SIZE, "FixedGeometry must be between 1 and MAX_BOARD_SIZE");
+
+		/**
+		 * The number of padded points a board of this size uses, and so how large its arrays are.
+		 */
+		static constexpr int MAX_POINTS = (N + 2) * (N + 1) + 1;
+
+		/**
+		 * The padded index offsets to the right, left, lower and upper neighbours of a point.
+		 */
+		static constexpr std::array<int, 4> NEIGHBOR_OFFSETS = {{1, -1, N + 1, -(N + 1)}};
+
+		/**
+		 * The padded index offsets to the four diagonal neighbours of a point.
+		 */
+		static constexpr std::array<int, 4> DIAGONAL_OFFSETS = {{N + 2, N, -N, -(N + 2)}};
+
+		/**
+		 * Constructs the geometry. The dimensions are only there so every geometry can be made from
+		 * a Grid2; this throws if they aren't N by N.
+		 * @param dimensions
+		 */
+		explicit FixedGeometry(const Grid2& dimensions = Grid2(N, N)) {
+			if (dimensions.X() != N || dimensions.Y() != N) {
+				std::stringstream s;
+				s << "FixedGeometry<" << N << "> cannot be " << dimensions.X() << "x" << dimensions.Y() << ".";
+				throw std::invalid_argument(s.str());
+			}
+		}
+
+		constexpr int Width() const {
+			return N;
+		}
+
+		constexpr int Height() const {
+			return N;
+		}
+
+		constexpr int Stride() const {
+			return N + 1;
+		}
+
+		constexpr int Points() const {
+			return MAX_POINTS;
+		}
+
+		const std::array<int, 4>& NeighborOffsets() const {
+			return NEIGHBOR_OFFSETS;
+		}
+
+		const std::array<int, 4>& DiagonalOffsets() const {
+			return DIAGONAL_OFFSETS;
+		}
+
+		/**
+		 * Returns which line from the edge a padded index is on, or 0 for a guard point.
+		 * @param index
+		 * @return
+		 */
+		int Line(int index) const {
+			return LINES.lines[index];
+		}
+
+		private:
+		static constexpr LineTable<N, N> LINES = LineTable<N, N>();
+	};
+
+	template <int N>
+	constexpr int FixedGeometry<N>::MAX_POINTS;
+
+	template <int N>
+	constexpr std::array<int, 4> FixedGeometry<N>::NEIGHBOR_OFFSETS;
+
+	template <int N>
+	constexpr std::array<int, 4> FixedGeometry<N>::DIAGONAL_OFFSETS;
+
+	template <int N>
+	constexpr LineTable<N, N> FixedGeometry<N>::LINES;
+
+	/**
+	 * The shape of a board only known at runtime. Storage is sized for the largest supported board.
+	 */
+	class DynamicGeometry {
+		public:
+		/**
+		 * The number of padded points the largest board uses, and so how large a board's arrays are.
+		 */
+		static constexpr int MAX_POINTS = MAX_PADDED_POINTS;
+
+		/**
+		 * Constructs the geometry of a board with the given dimensions. This throws if either
+		 * dimension is not between 1 and MAX_BOARD_SIZE.
+		 * @param dimensions
+		 */
+		explicit DynamicGeometry(const Grid2& dimensions) : _width(dimensions.X()), _height(dimensions.Y()), _neighborOffsets{{1, -1, dimensions.X() + 1, -(dimensions.X() + 1)}}, _diagonalOffsets{{dimensions.X() + 2, dimensions.X(), -dimensions.X(), -(dimensions.X() + 2)}} {
+			if (dimensions.X() < 1 || dimensions.X() > MAX_BOARD_SIZE || dimensions.Y() < 1 || dimensions.Y() > MAX_BOARD_SIZE) {
+				std::stringstream s;
+				s << "Board cannot be " << dimensions.X() << "x" << dimensions.Y() << "; both dimensions must be between 1 and " << MAX_BOARD_SIZE << ".";
+				throw std::invalid_argument(s.str());
+			}
+		}
+
+		int Width() const {
+			return _width;
+		}
+
+		int Height() const {
+			return _height;
+		}
+
+		int Stride() const {
+			return _width + 1;
+		}
+
+		int Points() const {
+			return (_height + 2) * (_width + 1) + 1;
+		}
+
+		const std::array<int, 4>& NeighborOffsets() const {
+			return _neighborOffsets;
+		}
+
+		const std::array<int, 4>& DiagonalOffsets() const {
+			return _diagonalOffsets;
+		}
+
+		/**
+		 * Returns which line from the edge a padded index is on, or 0 for a guard point.
+		 * @param index
+		 * @return
+		 */
+		int Line(int index) const {
+			return PaddedLine(index, _width, _height);
+		}
+
+		private:
+		int _width;
+		int _height;
+		std::array<int, 4> _neighborOffsets;
+		std::array<int, 4> _diagonalOffsets;
+	};
+}
@@ -15,12 +15,41 @@ namespace BeitaGo {
 		White
 	};
 
+	/**
+	 * The planes of points Board::GetFeaturePlane can give a network, on top of the stones.
+	 */
+	enum class FeaturePlane : uint8_t {
+		OneLiberty, // Stones of either color in a group with one liberty.
+		TwoLiberties, // Stones of either color in a group with two liberties.
+		ThreeOrMoreLiberties, // Stones of either color in a group with three or more liberties.
+		Ko, // The point the player to move can't take back because of ko.
+		Legal, // The points the player to move can play on.
+		CapturesOne, // The points where the player to move would capture one stone.
+		CapturesTwo, // The points where the player to move would capture two stones.
+		CapturesThreeOrMore // The points where the player to move would capture three or more stones.
+	};
+
+	/**
+	 * The number of values FeaturePlane has.
+	 */
+	constexpr int FEATURE_PLANE_COUNT = 8;
+
 	/**
 	* A useful term to indicate whether the player will pass their turn. Use this in
 	* ActDecision.
 	*/
 	const Grid2 PASS = Grid2(-6723, -2356);
 
+	/**
+	 * The largest width or height a board can have.
+	 */
+	constexpr int MAX_BOARD_SIZE = 25;
+
+	/**
+	 * The number of padded point indices the largest board uses (see Board).
+	 */
+	constexpr int MAX_PADDED_POINTS = (MAX_BOARD_SIZE + 2) * (MAX_BOARD_SIZE + 1) + 1;
+
 	/**
 	 * A default amount of time for a MCTS AI to use.
 	 */
@@ -3,13 +3,17 @@
 #include "MonteCarloAIPlayer.h"
 
 #include <array>
+#include <memory>
 
 #include <dlib/dnn.h>
 #include <dlib/data_io.h>
 
 #include "Board.h"
+#include "Point.h"
 
 namespace BeitaGo {
+	class NNMonteCarloTree;
+
 	class DeepLearningAIPlayer : public MonteCarloAIPlayer {
 		public:
 		//TODO: This could probably be dynamic at runtime to have different networks for different sizes.
@@ -27,9 +31,10 @@ namespace BeitaGo {
 		 * The network works by representing the board as a flattened 3D array of bools, two dimensions being the map
 		 * dimensions and the third being a number of layers. A number of previous turns are used, and there are two
 		 * layers used per turn to represent all the white tiles and black tiles. An extra layer is necessary to
-		 * indicate whose turn it currently is.
+		 * indicate whose turn it currently is. The board's feature planes follow, one layer each in FeaturePlane
+		 * order, so the network doesn't have to work out liberties, ko and legality from the stones itself.
 		 */
-		static constexpr int INPUT_VECTOR_SIZE = EXPECTED_BOARD_SIZE * EXPECTED_BOARD_SIZE * (2 * HISTORY_USED + 1);
+		static constexpr int INPUT_VECTOR_SIZE = EXPECTED_BOARD_SIZE * EXPECTED_BOARD_SIZE * (2 * HISTORY_USED + 1 + FEATURE_PLANE_COUNT);
 
 		/**
 		 * The network represents the output as just a vector of all the moves that can be done.
@@ -90,6 +95,21 @@ namespace BeitaGo {
 		 */
 		static dlib::matrix<unsigned char, INPUT_VECTOR_SIZE, 1> BoardToDlibMatrix(const Board& board);
 
+		/**
+		 * Returns the network output that stands for a move. Outputs are laid out as
+		 * Point::MoveIndex describes, so they line up with the children of a MonteCarloTree.
+		 * @param move
+		 * @return
+		 */
+		static unsigned long MoveToOutput(const Grid2& move);
+
+		/**
+		 * Returns the move a network output stands for.
+		 * @param output
+		 * @return
+		 */
+		static Grid2 OutputToMove(unsigned long output);
+
 		/**
 		 * Returns all the heuristic values computed by the last run of the MakeDecision() call.
 		 */
@@ -104,5 +124,6 @@ namespace BeitaGo {
 		NetworkType _network;
 		mutable std::array<double, OUTPUT_VECTOR_SIZE> _heuristicValues;
 		mutable int _totalSimulations;
+		mutable std::unique_ptr<NNMonteCarloTree> _networkTree; // Kept between moves so its nodes' memory is only set aside once.
 	};
 }
\ No newline at end of file
@@ -1,7 +1,11 @@
 #pragma once
 
+#include <memory>
+#include <mutex>
+
 #include "Board.h"
 #include "Player.h"
+#include "ThreadPool.h"
 
 namespace BeitaGo {
 	/**
@@ -72,10 +76,20 @@ namespace BeitaGo {
 		 */
 		const Player& GetPlayer2() const;
 
+		/**
+		 * Returns the workers that everything run by this engine shares, such as the AI's
+		 * searches. It's started the first time it's asked for, so engines that never think
+		 * don't start any threads. Any number of threads can ask for it at once.
+		 * @return
+		 */
+		ThreadPool& GetThreadPool() const;
+
 		private:
 		Board* _board;
 		Player* _player1;
 		Player* _player2;
+		mutable std::unique_ptr<ThreadPool> _threadPool;
+		mutable std::once_flag _threadPoolCreated;
 	};
 }
 
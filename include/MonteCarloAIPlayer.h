@@ -2,10 +2,13 @@
 
 #include <array>
 #include <chrono>
+#include <memory>
 
 #include "AIPlayer.h"
 
 namespace BeitaGo {
+	class MonteCarloTree;
+
 	/**
 	 * Defines an AI player that uses the Monte Carlo Tree Search to compute its decisions.
 	 */
@@ -28,6 +31,9 @@ namespace BeitaGo {
 
 		protected:
 		std::chrono::duration<double> _thinkingTime;
+
+		private:
+		mutable std::unique_ptr<MonteCarloTree> _tree; // Kept between moves so its nodes' memory is only set aside once.
 	};
 }
 
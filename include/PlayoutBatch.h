@@ -0,0 +1,138 @@
+#pragma once
+
+#include <cstdint>
+
+#include "Bitboard.h"
+#include "BoardGeometry.h"
+#include "Constants.h"
+#include "RandomStream.h"
+
+namespace BeitaGo {
+	class Board;
+
+	/**
+	 * Runs LANES random games on a 9x9 board at once, all starting from the same position. Each
+	 * game is a lane: its stones are two bitboard words, and every lane's words sit next to the
+	 * same word of the other lanes. Finding each lane's candidate moves and capturing its stones
+	 * are then the same bitwise steps over every lane, which the compiler turns into SIMD
+	 * instructions, so a core works through a whole batch of games about as fast as through one.
+	 * Only picking a move and the rare check for a move with no empty neighbours are done a lane
+	 * at a time.
+	 *
+	 * The games follow the same rules as a PlayoutBoard: moves are picked at random from those
+	 * that are legal and don't fill a player's own eye, a player with no such move passes, only
+	 * simple ko is checked, and a game ends after two passes in a row.
+	 */
+	class PlayoutBatch {
+		public:
+		/**
+		 * How many games are run at once.
+		 */
+		static constexpr int LANES = 8;
+
+		/**
+		 * The size of the board the games are played on.
+		 */
+		static constexpr int SIZE = 9;
+
+		/**
+		 * Copies the starting position out of a board. This throws if the board isn't 9x9.
+		 * @param board
+		 */
+		explicit PlayoutBatch(const Board& board);
+
+		/**
+		 * Plays every lane from the starting position to the end of its game, each lane with its
+		 * own stream split from the given one. This can be called again for another batch of
+		 * games.
+		 * @param random
+		 */
+		void Run(RandomStream& random);
+
+		/**
+		 * Returns how far ahead white is in a lane once Run is done, using area scoring and komi
+		 * like Board::Score.
+		 * @param lane
+		 * @return
+		 */
+		double Score(int lane) const;
+
+		/**
+		 * Returns the stones of a color in a lane, using FixedGeometry<SIZE>'s padded indices.
+		 * @param lane
+		 * @param color
+		 * @return
+		 */
+		BasicBitboard<2> GetStones(int lane, Color color) const;
+
+		private:
+		using Geometry = FixedGeometry<SIZE>;
+		using PointSet = BasicBitboard<(Geometry::MAX_POINTS + 63) / 64>;
+		static constexpr int WORDS = PointSet::WORDS;
+		static constexpr int STRIDE = SIZE + 1;
+
+		/**
+		 * One bitboard per lane, stored word by word so the same word of every lane is together.
+		 */
+		using LaneSets = uint64_t[WORDS][LANES];
+
+		static PointSet Load(const LaneSets& sets, int lane);
+		static void Store(LaneSets& sets, int lane, const PointSet& set);
+
+		/**
+		 * Plays every lane to the end of its game.
+		 */
+		void Play();
+
+		/**
+		 * Plays one move, or a pass, in every lane that hasn't finished.
+		 */
+		void Step();
+
+		/**
+		 * Picks a random legal move in a lane from its candidates, or returns -1 to pass.
+		 * @param lane
+		 * @param candidates
+		 * @param own
+		 * @param enemy
+		 * @return
+		 */
+		int PickMove(int lane, PointSet candidates, const PointSet& own, const PointSet& enemy);
+
+		/**
+		 * Returns whether playing at a point with no empty neighbours either captures or leaves
+		 * the new stone's group a liberty.
+		 * @param index
+		 * @param own
+		 * @param enemy
+		 * @return
+		 */
+		bool IsLegalWhenFilled(int index, const PointSet& own, const PointSet& enemy) const;
+
+		/**
+		 * Returns whether a group, grown through the given stones, touches any of the targets.
+		 * @param group
+		 * @param stones
+		 * @param targets
+		 * @return
+		 */
+		static bool Reaches(PointSet group, const PointSet& stones, const PointSet& targets);
+
+		PointSet _onBoard;
+		PointSet _edge;
+		PointSet _startBlack;
+		PointSet _startWhite;
+		PointSet _startKo;
+		Color _startTurn;
+		int _startPasses;
+		double _komi;
+
+		alignas(64) LaneSets _black;
+		alignas(64) LaneSets _white;
+		alignas(64) LaneSets _ko;
+		alignas(64) LaneSets _moves;
+		RandomStream _random[LANES];
+		uint8_t _passes[LANES];
+		Color _whoseTurn;
+	};
+}
@@ -0,0 +1,426 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <random>
+
+#include "Bitboard.h"
+#include "BoardGeometry.h"
+#include "Constants.h"
+#include "Grid2.h"
+#include "RandomStream.h"
+
+namespace BeitaGo {
+	class Board;
+
+	/**
+	 * A cut down board for running random games to the end. It only holds the stones, groups,
+	 * liberties, ko point, side to move and hash, all in fixed-size arrays, so it is trivially
+	 * copyable and starting a playout from one is a single memcpy. It keeps no history, so it
+	 * can't undo and only checks simple ko, not superko.
+	 *
+	 * Points use the same padded indices as BasicBoard. The implementation is compiled for
+	 * FixedGeometry<9>, FixedGeometry<13>, FixedGeometry<19> and DynamicGeometry.
+	 */
+	template <typename Geometry>
+	class BasicPlayoutBoard {
+		public:
+		/**
+		 * The number of padded points this board stores.
+		 */
+		static constexpr int MAX_POINTS = Geometry::MAX_POINTS;
+
+		/**
+		 * A bitboard just big enough for this board.
+		 */
+		using PointSet = BasicBitboard<(MAX_POINTS + 63) / 64>;
+
+		/**
+		 * The index Play takes to pass.
+		 */
+		static constexpr int PASS_INDEX = -1;
+
+		/**
+		 * The bit in a pattern where the atari flags start. See GetPattern.
+		 */
+		static constexpr int PATTERN_ATARI_SHIFT = 16;
+
+		/**
+		 * How many distinct patterns GetPattern can return, for sizing weight tables.
+		 */
+		static constexpr int PATTERN_COUNT = 1 << (PATTERN_ATARI_SHIFT + 4);
+
+		/**
+		 * Copies the position out of a board. This throws if the geometry can't hold the board's
+		 * dimensions.
+		 * @param board
+		 */
+		explicit BasicPlayoutBoard(const Board& board);
+
+		/**
+		 * Returns whether every point on the board has been settled for good by one color or
+		 * the other, as UnconditionalArea finds, so no more moves can change Score. This isn't
+		 * kept up to date as moves are played, so it's worth only asking now and then.
+		 * @return
+		 */
+		bool IsSettled() const;
+
+		/**
+		 * Returns the Color of whoever's turn it is.
+		 * @return
+		 */
+		Color GetWhoseTurn() const;
+
+		/**
+		 * Returns whether both players have passed in a row.
+		 * @return
+		 */
+		bool IsGameOver() const;
+
+		/**
+		 * Returns the tile placed at a given position, or None if it is off the board.
+		 * @param position
+		 * @return
+		 */
+		Color GetTile(const Grid2& position) const;
+
+		/**
+		 * Returns how many liberties a tile has, or -1 if the tile is None or off the board.
+		 * @param position
+		 * @return
+		 */
+		int GetLiberties(const Grid2& position) const;
+
+		/**
+		 * Returns a Zobrist hash of the current position, including whose turn it is. This
+		 * matches Board::GetHash for the same position.
+		 * @return
+		 */
+		uint64_t GetHash() const;
+
+		/**
+		 * Returns how many points on the board are empty.
+		 * @return
+		 */
+		int GetEmptyCount() const;
+
+		/**
+		 * Returns the padded index of a position on the board.
+		 * @param position
+		 * @return
+		 */
+		int ToIndex(const Grid2& position) const;
+
+		/**
+		 * Returns the position of a padded index, or PASS for PASS_INDEX.
+		 * @param index
+		 * @return
+		 */
+		Grid2 ToGrid2(int index) const;
+
+		/**
+		 * Returns whether the player to move can play at an on-board padded index.
+		 * @param index
+		 * @return
+		 */
+		bool IsLegal(int index) const;
+
+		/**
+		 * Plays a move for whoever's turn it is and hands the turn over. The move must be
+		 * PASS_INDEX or legal.
+		 * @param index
+		 */
+		void Play(int index);
+
+		/**
+		 * Returns whether an empty padded index is a true eye of the given color. This is the same
+		 * test as BasicBoard::IsEye.
+		 * @param index
+		 * @param color
+		 * @return
+		 */
+		bool IsEye(int index, Color color) const;
+
+		/**
+		 * Returns the 3x3 pattern around a padded index. Bits 2k and 2k + 1 hold the Tile of the
+		 * k-th neighbour, taking the four direct neighbours in the order of
+		 * Geometry::NeighborOffsets and then the four diagonals in the order of
+		 * Geometry::DiagonalOffsets. Bit PATTERN_ATARI_SHIFT + k is set when the k-th direct
+		 * neighbour is a stone in atari. The tiles are kept up to date as stones come and go, so
+		 * this is only a few reads.
+		 * @param index
+		 * @return
+		 */
+		uint32_t GetPattern(int index) const {
+			uint32_t pattern = _patterns[index];
+			const std::array<int, 4>& offsets = _geometry.NeighborOffsets();
+			for (int k = 0; k < 4; ++k) {
+				int neighbor = index + offsets[k];
+				Tile tile = _tiles[neighbor];
+				if ((tile == Tile::Black || tile == Tile::White) && _liberties[_groupOf[neighbor]] == 1) {
+					pattern |= 1u << (PATTERN_ATARI_SHIFT + k);
+				}
+			}
+			return pattern;
+		}
+
+		/**
+		 * Returns a random legal point for the player to move that doesn't fill one of their own
+		 * eyes, picked with a chance in proportion to weights[GetPattern(index)]. weights can be
+		 * anything indexed by a pattern that gives a non-negative number, such as an array of
+		 * PATTERN_COUNT floats. If every candidate weighs nothing, this falls back to
+		 * GetRandomMove.
+		 * @param random
+		 * @param weights
+		 * @return
+		 */
+		template <typename Random, typename Weights>
+		int GetWeightedMove(Random& random, const Weights& weights) const {
+			int candidates[MAX_POINTS];
+			double cumulative[MAX_POINTS];
+			int numCandidates = 0;
+			double total = 0.0;
+			for (int i = 0; i < _numEmpty; ++i) {
+				int index = _emptyPoints[i];
+				if (IsPlayoutMove(index)) {
+					double weight = weights[GetPattern(index)];
+					if (weight > 0.0) {
+						total += weight;
+						candidates[numCandidates] = index;
+						cumulative[numCandidates++] = total;
+					}
+				}
+			}
+			if (numCandidates == 0) {
+				return GetRandomMove(random);
+			}
+			double pick = std::uniform_real_distribution<double>(0.0, total)(random);
+			return candidates[std::min(static_cast<int>(std::upper_bound(cumulative, cumulative + numCandidates, pick) - cumulative), numCandidates - 1)];
+		}
+
+		/**
+		 * Returns a uniformly random legal point for the player to move that doesn't fill one of
+		 * their own eyes, or PASS_INDEX if there isn't one. This works the same way as
+		 * BasicBoard::GetRandomValidMove. Since nobody fills their own eyes or passes early, a
+		 * game played with this ends once both sides only have eyes and illegal points left.
+		 * @param random
+		 * @return
+		 */
+		template <typename Random>
+		int GetRandomMove(Random& random) const {
+			for (int attempt = 0; attempt < RANDOM_MOVE_ATTEMPTS && _numEmpty > 0; ++attempt) {
+				int index = _emptyPoints[RandomBelow(random, _numEmpty)];
+				if (IsPlayoutMove(index)) {
+					return index;
+				}
+			}
+			int legal[MAX_POINTS];
+			int numLegal = 0;
+			for (int i = 0; i < _numEmpty; ++i) {
+				if (IsPlayoutMove(_emptyPoints[i])) {
+					legal[numLegal++] = _emptyPoints[i];
+				}
+			}
+			if (numLegal == 0) {
+				return PASS_INDEX;
+			}
+			return legal[RandomBelow(random, numLegal)];
+		}
+
+		/**
+		 * Plays moves from GetRandomMove until both players pass, the board is settled, or
+		 * maxMoves have been played, and returns the score. A game that didn't end on its own
+		 * is scored with ScoreSettled, so a settled board scores as it would have played out.
+		 * @param random
+		 * @param maxMoves
+		 * @return
+		 */
+		template <typename Random>
+		double PlayOut(Random& random, int maxMoves) {
+			// IsSettled costs as much as several moves, and a board rarely settles more than a
+			// few moves before the game would end anyway, so it's only asked after a pass, which
+			// is when one side has run out of moves outside its eyes.
+			bool passed = false;
+			for (int i = 0; i < maxMoves && !IsGameOver(); ++i) {
+				if (passed && IsSettled()) {
+					break;
+				}
+				int move = GetRandomMove(random);
+				passed = move == PASS_INDEX;
+				Play(move);
+			}
+			return IsGameOver() ? Score() : ScoreSettled();
+		}
+
+		/**
+		 * Gets the current score using the area method. Positive is in favor of white, negative is
+		 * in favor of black.
+		 * @return
+		 */
+		double Score() const;
+
+		/**
+		 * Gets the score the same way as Score, except stones left inside an area the other
+		 * color has settled for good count as captured, as CountSettledArea describes. A playout
+		 * stopped once IsSettled scores the same this way as it would have played out.
+		 * @return
+		 */
+		double ScoreSettled() const;
+
+		private:
+		/**
+		 * How many random empty points GetRandomMove tries before listing the legal ones.
+		 */
+		static constexpr int RANDOM_MOVE_ATTEMPTS = 8;
+
+		/**
+		 * Runs a function on the padded index of each direct neighbour of a point.
+		 * @param index
+		 * @param f
+		 */
+		template <typename F>
+		void ForEachNeighbor(int index, F f) const {
+			const std::array<int, 4>& offsets = _geometry.NeighborOffsets();
+			f(index + offsets[0]);
+			f(index + offsets[1]);
+			f(index + offsets[2]);
+			f(index + offsets[3]);
+		}
+
+		/**
+		 * Returns whether the player to move can play at an index during a playout, which is
+		 * when it's legal and not one of their own eyes.
+		 * @param index
+		 * @return
+		 */
+		bool IsPlayoutMove(int index) const {
+			return IsLegal(index) && !IsEye(index, _whoseTurn);
+		}
+
+		/**
+		 * Returns the points a color has settled for good: the stones of its unconditionally
+		 * alive groups, which can't be captured even if it passes every turn, and the regions
+		 * those groups enclose where every empty point is one of their liberties. Any stones of
+		 * the other color in those regions are dead.
+		 *
+		 * This is Benson's algorithm with only single empty points surrounded by the color taken
+		 * as vital regions. Groups with fewer than two of those eyes are dropped, along with
+		 * every eye next to them, until no more can be dropped, and the groups left are alive.
+		 * That misses groups living on bigger eyes, but it never calls a group alive that isn't,
+		 * and it is cheap enough to ask during a playout.
+		 * @param color
+		 * @return
+		 */
+		PointSet UnconditionalArea(Color color) const;
+
+		/**
+		 * Changes the tile at a padded index, updating the patterns of the points around it.
+		 * @param index
+		 * @param tile
+		 */
+		void SetTile(int index, Tile tile);
+
+		/**
+		 * Puts a stone down while loading a position, without capturing or counting liberties.
+		 * @param index
+		 * @param color
+		 */
+		void SetStone(int index, Color color);
+
+		/**
+		 * Forms the groups and counts the liberties of every stone put down with SetStone.
+		 */
+		void BuildGroups();
+
+		/**
+		 * Counts the distinct liberties of a group by walking its stones.
+		 * @param group
+		 * @return
+		 */
+		int CountLiberties(int group) const;
+
+		/**
+		 * Joins two groups of the same color into one and returns the representative of the
+		 * result. Liberties are not updated.
+		 * @param a
+		 * @param b
+		 * @return
+		 */
+		int MergeGroups(int a, int b);
+
+		/**
+		 * Removes every stone of a group from the board, giving liberties back to the groups
+		 * around it. Returns how many stones were removed.
+		 * @param group
+		 * @param color
+		 * @return
+		 */
+		int RemoveGroup(int group, Color color);
+
+		/**
+		 * Adds a point that has just become empty to the empty point list.
+		 * @param index
+		 */
+		void AddEmpty(int index);
+
+		/**
+		 * Removes a point that has just been filled from the empty point list.
+		 * @param index
+		 */
+		void RemoveEmpty(int index);
+
+		Geometry _geometry;
+		std::array<Tile, MAX_POINTS> _tiles; // Every padded point, with Edge on the guard points.
+		std::array<uint16_t, MAX_POINTS> _patterns; // The tiles around each point, as in GetPattern.
+		PointSet _onBoard;
+		PointSet _black;
+		PointSet _white;
+		int _blackStones;
+		int _whiteStones;
+		std::array<int16_t, MAX_POINTS> _groupOf; // The representative stone of each point's group, or -1.
+		std::array<int16_t, MAX_POINTS> _nextStone; // Each group's stones form a circular list through this.
+		std::array<int16_t, MAX_POINTS> _groupSize; // Only meaningful for representatives.
+		std::array<int16_t, MAX_POINTS> _liberties; // Only meaningful for representatives.
+		std::array<int16_t, MAX_POINTS> _emptyPoints; // The first _numEmpty are the empty points, in no order.
+		std::array<int16_t, MAX_POINTS> _emptyPosition; // Where each empty point sits in _emptyPoints.
+		int _numEmpty;
+		int _koPoint; // The padded index the player to move can't play, or -1.
+		int _passes; // How many passes have been played in a row.
+		Color _whoseTurn;
+		uint64_t _hash;
+		double _komi;
+	};
+
+	template <typename Geometry>
+	constexpr int BasicPlayoutBoard<Geometry>::MAX_POINTS;
+
+	template <typename Geometry>
+	constexpr int BasicPlayoutBoard<Geometry>::PASS_INDEX;
+
+	template <typename Geometry>
+	constexpr int BasicPlayoutBoard<Geometry>::RANDOM_MOVE_ATTEMPTS;
+
+	template <typename Geometry>
+	constexpr int BasicPlayoutBoard<Geometry>::PATTERN_ATARI_SHIFT;
+
+	template <typename Geometry>
+	constexpr int BasicPlayoutBoard<Geometry>::PATTERN_COUNT;
+
+	/**
+	 * A playout board for any board size.
+	 */
+	using PlayoutBoard = BasicPlayoutBoard<DynamicGeometry>;
+
+	/**
+	 * A playout board whose size is fixed at compile time. FixedPlayoutBoard<9>,
+	 * FixedPlayoutBoard<13> and FixedPlayoutBoard<19> are available.
+	 */
+	template <int N>
+	using FixedPlayoutBoard = BasicPlayoutBoard<FixedGeometry<N>>;
+
+	extern template class BasicPlayoutBoard<FixedGeometry<9>>;
+	extern template class BasicPlayoutBoard<FixedGeometry<13>>;
+	extern template class BasicPlayoutBoard<FixedGeometry<19>>;
+	extern template class BasicPlayoutBoard<DynamicGeometry>;
+}
@@ -0,0 +1,165 @@
+#pragma once
+
+#include <cstdint>
+
+#include "Constants.h"
+#include "Grid2.h"
+
+namespace BeitaGo {
+	/**
+	 * A point on a board as a single row-major index, x + y * width, so it fits in 16 bits and
+	 * everything about it can be inlined. The width isn't stored, so conversions to and from x
+	 * and y take it. Grid2 is still what the public API takes; Point is for flattening moves into
+	 * arrays, such as the children of a search tree or the outputs of a network.
+	 */
+	class Point {
+		public:
+		/**
+		 * The index of a pass.
+		 */
+		static constexpr uint16_t PASS_INDEX = 0xFFFE;
+
+		/**
+		 * The index of no point at all.
+		 */
+		static constexpr uint16_t NONE_INDEX = 0xFFFF;
+
+		/**
+		 * Constructs a Point that is NONE.
+		 */
+		constexpr Point() : _index(NONE_INDEX) {}
+
+		/**
+		 * Constructs a Point from its row-major index.
+		 * @param index
+		 */
+		constexpr explicit Point(int index) : _index(static_cast<uint16_t>(index)) {}
+
+		/**
+		 * Returns the Point at (x, y) on a board of the given width.
+		 * @param x
+		 * @param y
+		 * @param width
+		 * @return
+		 */
+		static constexpr Point At(int x, int y, int width) {
+			return Point(x + y * width);
+		}
+
+		/**
+		 * Returns the Point of a position on a board of the given width, turning PASS into
+		 * Point::Pass().
+		 * @param position
+		 * @param width
+		 * @return
+		 */
+		static Point FromGrid2(const Grid2& position, int width) {
+			return position == PASS ? Pass() : At(position.X(), position.Y(), width);
+		}
+
+		/**
+		 * Returns the Point of a pass.
+		 * @return
+		 */
+		static constexpr Point Pass() {
+			return Point(PASS_INDEX);
+		}
+
+		/**
+		 * Returns the Point that isn't anywhere.
+		 * @return
+		 */
+		static constexpr Point None() {
+			return Point(NONE_INDEX);
+		}
+
+		/**
+		 * Returns the row-major index of this Point.
+		 * @return
+		 */
+		constexpr int Index() const {
+			return _index;
+		}
+
+		/**
+		 * Returns whether this Point is a pass.
+		 * @return
+		 */
+		constexpr bool IsPass() const {
+			return _index == PASS_INDEX;
+		}
+
+		/**
+		 * Returns whether this Point is NONE.
+		 * @return
+		 */
+		constexpr bool IsNone() const {
+			return _index == NONE_INDEX;
+		}
+
+		/**
+		 * Returns the x position of this Point on a board of the given width. This Point must be
+		 * on the board.
+		 * @param width
+		 * @return
+		 */
+		constexpr int X(int width) const {
+			return _index % width;
+		}
+
+		/**
+		 * Returns the y position of this Point on a board of the given width. This Point must be
+		 * on the board.
+		 * @param width
+		 * @return
+		 */
+		constexpr int Y(int width) const {
+			return _index / width;
+		}
+
+		/**
+		 * Returns where this Point is on a board of the given width, or PASS for a pass. This
+		 * Point must not be NONE.
+		 * @param width
+		 * @return
+		 */
+		Grid2 ToGrid2(int width) const {
+			return IsPass() ? PASS : Grid2(X(width), Y(width));
+		}
+
+		/**
+		 * Returns where this Point goes in an array of every point on a board followed by a pass,
+		 * which is how search trees and networks lay out their moves.
+		 * @param points The number of points on the board.
+		 * @return
+		 */
+		constexpr int MoveIndex(int points) const {
+			return IsPass() ? points : _index;
+		}
+
+		/**
+		 * Returns the Point at an index of an array laid out as MoveIndex describes.
+		 * @param moveIndex
+		 * @param points The number of points on the board.
+		 * @return
+		 */
+		static constexpr Point FromMoveIndex(int moveIndex, int points) {
+			return moveIndex == points ? Pass() : Point(moveIndex);
+		}
+
+		constexpr bool operator==(const Point& o) const {
+			return _index == o._index;
+		}
+
+		constexpr bool operator!=(const Point& o) const {
+			return _index != o._index;
+		}
+
+		constexpr bool operator<(const Point& o) const {
+			return _index < o._index;
+		}
+
+		private:
+		uint16_t _index;
+	};
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Board.h"
+
+namespace BeitaGo {
+	/**
+	 * How many of the latest moves PackPosition keeps by default.
+	 */
+	constexpr int PACKED_HISTORY_MOVES = 8;
+
+	/**
+	 * Packs a board's position into a compact binary form for datasets, caches and queues. It
+	 * holds the stones at 2 bits per point, whose turn it is, the turn count, the ko point, the
+	 * captures, the komi (to the nearest half point) and up to historyMoves of the latest moves,
+	 * so a 9x9 position takes about 50 bytes. Superko history and anything older isn't kept.
+	 *
+	 * The layout is, with every number little-endian:
+	 * - 1 byte: format version, currently 1
+	 * - 1 byte each: width, height, whose turn
+	 * - 2 bytes each: turn count, ko point (or 0xFFFF), black's and white's captures, komi in
+	 *   half points (signed)
+	 * - 1 byte: number of moves that follow, oldest first, then 2 bytes per move with the point
+	 *   in the low 15 bits (0x7FFF for a pass) and the top bit set for white
+	 * - (width * height + 3) / 4 bytes: the stones, 2 bits per point as Color values
+	 *
+	 * Points are numbered x + y * width.
+	 * @param board
+	 * @param historyMoves
+	 * @return
+	 */
+	std::vector<uint8_t> PackPosition(const Board& board, int historyMoves = PACKED_HISTORY_MOVES);
+
+	/**
+	 * Makes a board from a position packed by PackPosition. The board starts at that position,
+	 * as Board::LoadPosition describes. This throws if the data is cut short or isn't a valid
+	 * position.
+	 * @param data
+	 * @param size
+	 * @return
+	 */
+	Board UnpackPosition(const uint8_t* data, size_t size);
+
+	/**
+	 * Makes a board from a position packed by PackPosition.
+	 * @param data
+	 * @return
+	 */
+	Board UnpackPosition(const std::vector<uint8_t>& data);
+}
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <random>
+
+namespace BeitaGo {
+	/**
+	 * A small, fast random number generator (xoshiro256**) meant to be owned by one thread. A
+	 * search picks one seed and gives each of its threads a different stream of it, so the
+	 * threads play different games and a search can be run again with the same seed.
+	 *
+	 * It meets the standard's UniformRandomBitGenerator requirements, so it can be passed to
+	 * anything that takes a std::default_random_engine as a template, but RandomBelow is quicker
+	 * than a std::uniform_int_distribution.
+	 */
+	class RandomStream {
+		public:
+		using result_type = uint64_t;
+
+		/**
+		 * Constructs the given stream of a seed. The pair is spread over the whole state by
+		 * SplitMix64, as xoshiro's authors suggest, so nearby seeds and streams start far apart.
+		 * Two pairs can still land on the same state, since the pair is folded into one word
+		 * first, but that's as unlikely as any two random seeds being equal.
+		 * @param seed
+		 * @param stream
+		 */
+		explicit RandomStream(uint64_t seed = 0, uint64_t stream = 0) {
+			uint64_t x = seed ^ (stream * 0xD1B54A32D192ED03ULL);
+			for (uint64_t& s : _state) {
+				uint64_t z = (x += 0x9E3779B97F4A7C15ULL);
+				z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+				z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+				s = z ^ (z >> 31);
+			}
+		}
+
+		static constexpr result_type min() {
+			return 0;
+		}
+
+		static constexpr result_type max() {
+			return std::numeric_limits<result_type>::max();
+		}
+
+		/**
+		 * Returns the next 64 random bits.
+		 * @return
+		 */
+		result_type operator()() {
+			uint64_t result = RotateLeft(_state[1] * 5, 7) * 9;
+			uint64_t t = _state[1] << 17;
+			_state[2] ^= _state[0];
+			_state[3] ^= _state[1];
+			_state[1] ^= _state[2];
+			_state[0] ^= _state[3];
+			_state[2] ^= t;
+			_state[3] = RotateLeft(_state[3], 45);
+			return result;
+		}
+
+		/**
+		 * Returns a new stream seeded from this one, for handing out to something that needs its
+		 * own, such as a lane of a PlayoutBatch.
+		 * @return
+		 */
+		RandomStream Split() {
+			return RandomStream((*this)());
+		}
+
+		/**
+		 * Returns a uniformly random number from 0 to n - 1, which must be at least 1. This
+		 * multiplies instead of dividing, and only draws again in the rare case that would
+		 * otherwise favour some numbers (Lemire's method).
+		 * @param n
+		 * @return
+		 */
+		uint32_t Below(uint32_t n) {
+			uint64_t m = ((*this)() >> 32) * n;
+			uint32_t low = static_cast<uint32_t>(m);
+			if (low < n) {
+				uint32_t threshold = (0u - n) % n;
+				while (low < threshold) {
+					m = ((*this)() >> 32) * n;
+					low = static_cast<uint32_t>(m);
+				}
+			}
+			return static_cast<uint32_t>(m >> 32);
+		}
+
+		private:
+		uint64_t _state[4];
+
+		static uint64_t RotateLeft(uint64_t x, int k) {
+			return (x << k) | (x >> (64 - k));
+		}
+	};
+
+	/**
+	 * Returns a uniformly random number from 0 to n - 1 using any standard random engine.
+	 * @param random
+	 * @param n
+	 * @return
+	 */
+	template <typename Random>
+	int RandomBelow(Random& random, int n) {
+		return std::uniform_int_distribution<int>(0, n - 1)(random);
+	}
+
+	/**
+	 * Returns a uniformly random number from 0 to n - 1 using RandomStream's own quicker way.
+	 * @param random
+	 * @param n
+	 * @return
+	 */
+	inline int RandomBelow(RandomStream& random, int n) {
+		return static_cast<int>(random.Below(static_cast<uint32_t>(n)));
+	}
+}
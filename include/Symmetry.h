@@ -0,0 +1,65 @@
+#pragma once
+
+#include "Constants.h"
+#include "Grid2.h"
+
+namespace BeitaGo {
+	/**
+	 * How many ways a board can be rotated and reflected onto itself or its transpose.
+	 *
+	 * A transform is a number from 0 to SYMMETRY_COUNT - 1. Bit 2 swaps x and y first, then bit
+	 * 0 mirrors x and bit 1 mirrors y, so 0 leaves the board alone. Transforms with bit 2 set
+	 * turn a WxH board into an HxW one, so on a board that isn't square only 0 to 3 map the
+	 * board onto itself.
+	 */
+	constexpr int SYMMETRY_COUNT = 8;
+
+	/**
+	 * Returns the dimensions of a board after a transform.
+	 * @param transform
+	 * @param dimensions
+	 * @return
+	 */
+	inline Grid2 TransformDimensions(int transform, const Grid2& dimensions) {
+		return (transform & 4) ? Grid2(dimensions.Y(), dimensions.X()) : dimensions;
+	}
+
+	/**
+	 * Returns whether a transform maps a board of the given dimensions onto itself.
+	 * @param transform
+	 * @param dimensions
+	 * @return
+	 */
+	inline bool IsSymmetryOf(int transform, const Grid2& dimensions) {
+		return !(transform & 4) || dimensions.X() == dimensions.Y();
+	}
+
+	/**
+	 * Returns where a position on a board of the given dimensions ends up after a transform.
+	 * PASS stays PASS.
+	 * @param transform
+	 * @param position
+	 * @param dimensions
+	 * @return
+	 */
+	inline Grid2 TransformPoint(int transform, const Grid2& position, const Grid2& dimensions) {
+		if (position == PASS) {
+			return PASS;
+		}
+		Grid2 size = TransformDimensions(transform, dimensions);
+		int x = (transform & 4) ? position.Y() : position.X();
+		int y = (transform & 4) ? position.X() : position.Y();
+		return Grid2((transform & 1) ? size.X() - 1 - x : x, (transform & 2) ? size.Y() - 1 - y : y);
+	}
+
+	/**
+	 * Returns the transform that undoes the given one.
+	 * @param transform
+	 * @return
+	 */
+	inline int InverseTransform(int transform) {
+		// Mirroring before swapping the axes is the same as swapping them and then mirroring the
+		// other axis.
+		return (transform & 4) ? 4 | ((transform & 1) << 1) | ((transform & 2) >> 1) : transform;
+	}
+}
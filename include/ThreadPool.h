@@ -0,0 +1,114 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace BeitaGo {
+	/**
+	 * A set of worker threads that lives as long as it does, so work can be spread over the
+	 * machine without starting threads every time. Each worker keeps its own queue of tasks and
+	 * takes from the back of it, and a worker with nothing to do steals from the front of
+	 * another's, so a task that adds more tasks mostly keeps them on its own thread.
+	 */
+	class ThreadPool {
+		public:
+		/**
+		 * Starts the given number of workers, at least one.
+		 * @param threads
+		 */
+		explicit ThreadPool(int threads = DefaultThreadCount());
+
+		/**
+		 * Finishes the tasks that are queued and stops every worker.
+		 */
+		~ThreadPool();
+
+		ThreadPool(const ThreadPool&) = delete;
+		ThreadPool& operator=(const ThreadPool&) = delete;
+
+		/**
+		 * Returns how many workers there are.
+		 * @return
+		 */
+		int Size() const;
+
+		/**
+		 * Runs task(i) once for every i from 0 to count - 1 across the workers, and returns once
+		 * they've all finished. The calling thread runs tasks too while it waits, so this can be
+		 * called from inside a task. If any of them throw, the rest still run, and then the first
+		 * exception is thrown again from here.
+		 * @param count
+		 * @param task
+		 */
+		void ParallelFor(int count, const std::function<void(int)>& task);
+
+		/**
+		 * Returns how many threads this machine can run at once, or 1 if it doesn't say.
+		 * @return
+		 */
+		static int DefaultThreadCount();
+
+		private:
+		/**
+		 * The tasks of one ParallelFor call.
+		 */
+		struct Job {
+			const std::function<void(int)>* task;
+			std::atomic<int> remaining;
+			std::mutex lock;
+			std::condition_variable done;
+			std::exception_ptr error; // The first exception a task threw, guarded by lock.
+		};
+
+		/**
+		 * One index of a Job.
+		 */
+		struct Task {
+			Job* job;
+			int index;
+		};
+
+		/**
+		 * A worker's queue.
+		 */
+		struct Queue {
+			std::mutex lock;
+			std::deque<Task> tasks;
+		};
+
+		std::vector<std::unique_ptr<Queue>> _queues;
+		std::vector<std::thread> _workers;
+		std::atomic<int> _queued;
+		std::atomic<unsigned int> _nextQueue;
+		bool _stopping;
+		std::mutex _sleepLock;
+		std::condition_variable _wake;
+
+		/**
+		 * The loop each worker runs until the pool stops.
+		 * @param worker
+		 */
+		void WorkerLoop(int worker);
+
+		/**
+		 * Takes a task, first from the back of the given queue and then from the front of any
+		 * other, and runs it. Returns false if every queue was empty.
+		 * @param queue
+		 * @return
+		 */
+		bool RunOne(int queue);
+
+		/**
+		 * Returns the queue of the worker running this, or -1 if it isn't one of this pool's.
+		 * @return
+		 */
+		int CurrentWorker() const;
+	};
+}
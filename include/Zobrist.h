@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdint>
+
+#include "Constants.h"
+
+namespace BeitaGo {
+	/**
+	 * The random keys that make up a Zobrist hash. They come from a fixed seed so hashes are the
+	 * same between runs and can be stored. Keys are indexed by padded point (see BasicBoard), so
+	 * every kind of board hashes a position the same way.
+	 */
+	struct ZobristKeys {
+		uint64_t stones[2][MAX_PADDED_POINTS];
+		uint64_t whiteToMove;
+
+		ZobristKeys() {
+			// SplitMix64, which is enough to give well spread keys.
+			uint64_t state = 0x4265697461476f21ULL;
+			auto next = [&state]() {
+				uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+				z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+				z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+				return z ^ (z >> 31);
+			};
+			for (int c = 0; c < 2; ++c) {
+				for (int i = 0; i < MAX_PADDED_POINTS; ++i) {
+					stones[c][i] = next();
+				}
+			}
+			whiteToMove = next();
+		}
+	};
+
+	/**
+	 * Returns the Zobrist keys shared by every board.
+	 * @return
+	 */
+	inline const ZobristKeys& Zobrist() {
+		static const ZobristKeys keys;
+		return keys;
+	}
+
+	/**
+	 * Returns the key for a stone of the given color on a padded point.
+	 * @param index
+	 * @param color
+	 * @return
+	 */
+	inline uint64_t StoneKey(int index, Color color) {
+		return Zobrist().stones[color == Color::Black ? 0 : 1][index];
+	}
+}
@@ -0,0 +1,55 @@
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "Board.h"
+#include "DeepLearning/MonteCarloTree.h"
+#include "ThreadPool.h"
+
+using namespace BeitaGo;
+
+int main(int argc, char* argv[]) {
+	double seconds = 3.0;
+	int maxThreads = ThreadPool::DefaultThreadCount();
+	std::vector<int> sizes;
+	for (int i = 1; i + 1 < argc; i += 2) {
+		if (std::string(argv[i]) == "-t") {
+			seconds = std::stod(argv[i + 1]);
+		} else if (std::string(argv[i]) == "-j") {
+			maxThreads = std::stoi(argv[i + 1]);
+		} else if (std::string(argv[i]) == "-s") {
+			sizes.push_back(std::stoi(argv[i + 1]));
+		}
+	}
+	if (sizes.empty()) {
+		sizes = {9, 19};
+	}
+
+	std::cout << "Searching an empty board for " << seconds << "s with 1 to " << maxThreads << " threads.\n";
+	std::cout << std::fixed << std::setprecision(2);
+	for (int size : sizes) {
+		Board board(Grid2(size, size));
+		double baseRate = 0.0;
+
+		// Doubles the threads each time, and always finishes on the most asked for.
+		for (int threads = 1; threads <= maxThreads; threads = threads == maxThreads ? maxThreads + 1 : std::min(threads * 2, maxThreads)) {
+			ThreadPool pool(threads);
+			MonteCarloTree tree(board, pool);
+			std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+			tree.RunSimulations(start + std::chrono::duration_cast<std::chrono::high_resolution_clock::duration>(std::chrono::duration<double>(seconds)));
+			double elapsed = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+
+			double rate = tree.GetTotalSimulations() / elapsed;
+			if (threads == 1) {
+				baseRate = rate;
+			}
+			double speedup = rate / baseRate;
+			std::cout << size << "x" << size << " " << std::setw(3) << threads << " threads: " << std::setw(10) << rate << " playouts/s, " << speedup << "x speedup, " << speedup / threads * 100.0 << "% efficiency, " << tree.GetNodeCount() << " nodes, depth " << tree.GetPrincipalDepth() << "\n";
+		}
+	}
+
+	return 0;
+}
@@ -82,7 +82,7 @@ std::pair<std::vector<dlib::matrix<unsigned char>>, std::vector<unsigned long>>
 		auto inputVector = DeepLearningAIPlayer::BoardToInputVector(e.GetBoard());
 		// And let's predict the move that is generated from this move.
 		auto decidedMove = dynamic_cast<MonteCarloAIPlayer&>(e.GetCurrentPlayer()).MakeDecision();
-		unsigned long decidedMoveValue = decidedMove == PASS ? DeepLearningAIPlayer::OUTPUT_VECTOR_SIZE - 1 : decidedMove.X() * DeepLearningAIPlayer::EXPECTED_BOARD_SIZE + decidedMove.Y();
+		unsigned long decidedMoveValue = DeepLearningAIPlayer::MoveToOutput(decidedMove);
 
 		// Let's convert the input vector into a dlib matrix.
 		dlib::matrix<unsigned char, DeepLearningAIPlayer::INPUT_VECTOR_SIZE, 1> inMatrix;
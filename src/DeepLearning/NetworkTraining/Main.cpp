@@ -70,7 +70,7 @@ std::pair<std::vector<dlib::matrix<unsigned char>>, std::vector<unsigned long>>
 
 			Grid2 chosenMove = player.MakeDecision();
 			p.first.push_back(DeepLearningAIPlayer::BoardToDlibMatrix(e.GetBoard()));
-			p.second.push_back(chosenMove == PASS ? DeepLearningAIPlayer::OUTPUT_VECTOR_SIZE - 1 : chosenMove.X() * DeepLearningAIPlayer::EXPECTED_BOARD_SIZE + chosenMove.Y());
+			p.second.push_back(DeepLearningAIPlayer::MoveToOutput(chosenMove));
 			player.ActDecision(chosenMove);
 			
 			std::cout << "      Ran " << player.GetTotalSimulations() << " simulations\n";
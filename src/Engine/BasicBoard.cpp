@@ -0,0 +1,1173 @@
+#include "BasicBoard.h"
+
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+
+#include <iostream>
+
+#include "Zobrist.h"
+
+namespace BeitaGo {
+	template <typename Geometry>
+	BasicBoard<Geometry>::BasicBoard(const Geometry& geometry) : _geometry(geometry) {
+		// Every bound here is a constant for a fixed geometry, so this is just a few stores.
+		for (int i = 0; i < MAX_POINTS; ++i) {
+			if (i < _geometry.Points() && _geometry.Line(i) != 0) {
+				_tiles[i] = Tile::None;
+				_onBoard.Set(i);
+			} else {
+				_tiles[i] = Tile::Edge;
+			}
+			_groupOf[i] = -1;
+			_nextStone[i] = -1;
+			_groupSize[i] = 0;
+			_liberties[i] = PointSet();
+			_libertyCount[i] = 0;
+			_outline[i] = PointSet();
+			_emptyPosition[i] = -1;
+		}
+		_numEmpty = 0;
+		_blackStones = 0;
+		_whiteStones = 0;
+		_onBoard.ForEach([this](int index) {
+			AddEmpty(index);
+		});
+		_whoseTurn = Color::Black;
+		_blackPiecesTaken = 0;
+		_whitePiecesTaken = 0;
+		_turnCount = 1;
+		_komi = 6.5;
+		_hash = 0;
+		_symmetryHashes.fill(0);
+		_koPoint = -1;
+		_koColor = Color::None;
+		RecordPosition();
+	}
+
+	template <typename Geometry>
+	BasicBoard<Geometry>::BasicBoard(const Grid2& dimensions) : BasicBoard(Geometry(dimensions)) {}
+
+	template <typename Geometry>
+	Grid2 BasicBoard<Geometry>::GetDimensions() const {
+		return Grid2(_geometry.Width(), _geometry.Height());
+	}
+
+	template <typename Geometry>
+	Color BasicBoard<Geometry>::GetTile(const Grid2& position) const {
+		if (!IsWithinBoard(position)) {
+			return Color::None;
+		}
+		return static_cast<Color>(_tiles[ToIndex(position)]);
+	}
+
+	template <typename Geometry>
+	Color BasicBoard<Geometry>::GetWhoseTurn() const {
+		return _whoseTurn;
+	}
+
+	template <typename Geometry>
+	int BasicBoard<Geometry>::GetTurnCount() const {
+		return _turnCount;
+	}
+
+	template <typename Geometry>
+	bool BasicBoard<Geometry>::IsGameOver() const {
+		return _history.size() >= 2 && (_history.end() - 2)->GetPosition() == PASS && (_history.end() - 1)->GetPosition() == PASS;
+	}
+
+	template <typename Geometry>
+	void BasicBoard<Geometry>::PlacePiece(const Grid2& position, Color color) {
+		if (IsMoveValid(position, color)) {
+			UndoEntry entry;
+			entry.index = position == PASS ? -1 : ToIndex(position);
+			entry.color = color;
+			entry.capturesBegin = static_cast<int>(_capturedStones.size());
+			entry.hash = _hash;
+			entry.koPoint = _koPoint;
+			entry.koColor = _koColor;
+			entry.whoseTurn = _whoseTurn;
+			entry.turnCount = _turnCount;
+			_undoLog.push_back(entry);
+			_koPoint = -1;
+			if (position != PASS) {
+				int index = ToIndex(position);
+				Color enemyColor = color == Color::Black ? Color::White : Color::Black;
+				Stones(color).Set(index);
+				_tiles[index] = ToTile(color);
+				++StoneCount(color);
+				RemoveEmpty(index);
+				_hash ^= StoneKey(index, color);
+				ToggleSymmetryKeys(index, color);
+				_groupOf[index] = index;
+				_nextStone[index] = index;
+				_groupSize[index] = 1;
+
+				// Find the distinct groups around the new stone. There can be at most four.
+				int friendlyGroups[4];
+				int numFriendlyGroups = 0;
+				int enemyGroups[4];
+				int numEnemyGroups = 0;
+				PointSet liberties;
+				PointSet outline;
+				ForEachNeighbor(index, [&](int neighbor) {
+					Tile tile = _tiles[neighbor];
+					int group = _groupOf[neighbor];
+					if (tile != Tile::Edge) {
+						outline.Set(neighbor);
+					}
+					if (tile == Tile::None) {
+						liberties.Set(neighbor);
+					} else if (tile == ToTile(color)) {
+						if (std::find(friendlyGroups, friendlyGroups + numFriendlyGroups, group) == friendlyGroups + numFriendlyGroups) {
+							friendlyGroups[numFriendlyGroups++] = group;
+						}
+					} else if (tile != Tile::Edge && std::find(enemyGroups, enemyGroups + numEnemyGroups, group) == enemyGroups + numEnemyGroups) {
+						enemyGroups[numEnemyGroups++] = group;
+					}
+				});
+
+				// Join the new stone with its friendly neighbours. The joined group breathes
+				// through everything its parts did, apart from the point just filled.
+				int group = index;
+				for (int i = 0; i < numFriendlyGroups; ++i) {
+					liberties |= _liberties[friendlyGroups[i]];
+					outline |= _outline[friendlyGroups[i]];
+					group = MergeGroups(group, friendlyGroups[i]);
+				}
+				liberties.Reset(index);
+				SetLiberties(group, liberties);
+				// Any friendly stone next to the group is now part of it. The enemy groups around
+				// already had this point in their outlines, and keep it.
+				_outline[group] = outline & ~Stones(color);
+
+				// Every enemy group touching the new stone loses a liberty, and is captured if that
+				// was its last.
+				int& points = (color == Color::Black ? _blackPiecesTaken : _whitePiecesTaken);
+				int captured = 0;
+				int capturedPoint = -1;
+				for (int i = 0; i < numEnemyGroups; ++i) {
+					RemoveLiberty(enemyGroups[i], index);
+					if (_liberties[enemyGroups[i]].None()) {
+						capturedPoint = enemyGroups[i];
+						captured += RemoveGroup(enemyGroups[i], enemyColor);
+					}
+				}
+				points += captured;
+
+				// A lone stone that captured a lone stone and is left in atari is a ko, so the
+				// other player can't take straight back.
+				if (captured == 1 && _groupSize[_groupOf[index]] == 1 && LibertyCount(_groupOf[index]) == 1) {
+					_koPoint = capturedPoint;
+					_koColor = enemyColor;
+				}
+				RecordPosition();
+			}
+			_history.emplace_back(position, color);
+		} else {
+			std::stringstream s;
+			s << "Board tried to place a " << (color == Color::Black ? "BLACK" : "WHITE") << " piece at (" << position.X() << ", " << position.Y() << ") but it is invalid. Your AI or UI should check IsMoveValid() is true before calling PlacePiece() or ActDecision()!";
+			throw std::runtime_error(s.str());
+		}
+	}
+
+	template <typename Geometry>
+	bool BasicBoard<Geometry>::IsMoveValid(const Grid2& position, Color color) const {
+		if (position == PASS || (IsWithinBoard(position) && IsLegal(ToIndex(position), color))) {
+			return true;
+		} else {
+			return false;
+		}
+	}
+
+	template <typename Geometry>
+	bool BasicBoard<Geometry>::IsMoveKo(const Grid2& position, Color color) const {
+		return IsWithinBoard(position) && IsKo(ToIndex(position), color);
+	}
+
+	template <typename Geometry>
+	bool BasicBoard<Geometry>::IsMoveSuperko(const Grid2& position, Color color) const {
+		return IsWithinBoard(position) && IsSuperko(ToIndex(position), color);
+	}
+
+	template <typename Geometry>
+	bool BasicBoard<Geometry>::IsMoveSuicidePlay(const Grid2& position, Color color) const {
+		return IsWithinBoard(position) && IsSuicide(ToIndex(position), color);
+	}
+
+	template <typename Geometry>
+	bool BasicBoard<Geometry>::IsEye(const Grid2& position, Color color) const {
+		return IsWithinBoard(position) && IsTrueEye(ToIndex(position), color);
+	}
+
+	template <typename Geometry>
+	bool BasicBoard<Geometry>::IsWithinBoard(const Grid2& position) const {
+		return position.X() >= 0 && position.X() < _geometry.Width() && position.Y() >= 0 && position.Y() < _geometry.Height();
+	}
+
+	template <typename Geometry>
+	std::vector<Grid2> BasicBoard<Geometry>::GetValidMoves(const Color& color) const {
+		std::vector<Grid2> v;
+		v.reserve(GetDimensions().X() * GetDimensions().Y() + 1);
+
+		// Bits run in row order, which keeps the old ordering of moves.
+		LegalPoints(color).ForEach([&](int index) {
+			v.push_back(ToGrid2(index));
+		});
+
+		v.push_back(PASS);
+
+		return v;
+	}
+
+	template <typename Geometry>
+	Bitboard BasicBoard<Geometry>::LegalMask(Color color) const {
+		return ToPointOrder(LegalPoints(color));
+	}
+
+	template <typename Geometry>
+	Bitboard BasicBoard<Geometry>::GetStoneMask(Color color) const {
+		return ToPointOrder(Stones(color));
+	}
+
+	template <typename Geometry>
+	Bitboard BasicBoard<Geometry>::GetFeaturePlane(FeaturePlane plane) const {
+		PointSet points;
+		switch (plane) {
+			case FeaturePlane::OneLiberty:
+				points = _oneLibertyStones;
+				break;
+			case FeaturePlane::TwoLiberties:
+				points = _twoLibertyStones;
+				break;
+			case FeaturePlane::ThreeOrMoreLiberties:
+				points = (_black | _white) & ~(_oneLibertyStones | _twoLibertyStones);
+				break;
+			case FeaturePlane::Ko:
+				if (_koPoint != -1 && _koColor == _whoseTurn) {
+					points.Set(_koPoint);
+				}
+				break;
+			case FeaturePlane::Legal:
+				points = LegalPoints(_whoseTurn);
+				break;
+			case FeaturePlane::CapturesOne:
+			case FeaturePlane::CapturesTwo:
+			case FeaturePlane::CapturesThreeOrMore: {
+				// Each enemy group in atari is captured at its last liberty, and groups sharing
+				// one are captured together, so their sizes add up there.
+				int liberties[MAX_POINTS];
+				int captured[MAX_POINTS];
+				int numLiberties = 0;
+				(_atari & Stones(_whoseTurn == Color::Black ? Color::White : Color::Black)).ForEach([&](int group) {
+					int liberty;
+					FindLiberties(group, &liberty, 1);
+					int i = static_cast<int>(std::find(liberties, liberties + numLiberties, liberty) - liberties);
+					if (i == numLiberties) {
+						liberties[numLiberties] = liberty;
+						captured[numLiberties++] = 0;
+					}
+					captured[i] += _groupSize[group];
+				});
+				int low = plane == FeaturePlane::CapturesOne ? 1 : plane == FeaturePlane::CapturesTwo ? 2 : 3;
+				int high = plane == FeaturePlane::CapturesThreeOrMore ? MAX_POINTS : low;
+				for (int i = 0; i < numLiberties; ++i) {
+					if (captured[i] >= low && captured[i] <= high) {
+						points.Set(liberties[i]);
+					}
+				}
+				break;
+			}
+		}
+		return ToPointOrder(points);
+	}
+
+	template <typename Geometry>
+	Bitboard BasicBoard<Geometry>::ToPointOrder(const PointSet& points) const {
+		// Each row is already a run of bits in the padded order, so it moves over whole.
+		int width = _geometry.Width();
+		int stride = _geometry.Stride();
+		Bitboard mask;
+		for (int y = 0; y < _geometry.Height(); ++y) {
+			mask.OrBits(y * width, width, points.GetBits((y + 1) * stride + 1, width));
+		}
+		return mask;
+	}
+
+	template <typename Geometry>
+	int BasicBoard<Geometry>::GetEmptyCount() const {
+		return _numEmpty;
+	}
+
+	template <typename Geometry>
+	double BasicBoard<Geometry>::GetKomi() const {
+		return _komi;
+	}
+
+	template <typename Geometry>
+	void BasicBoard<Geometry>::SetKomi(double komi) {
+		_komi = komi;
+	}
+
+	template <typename Geometry>
+	double BasicBoard<Geometry>::Score() const {
+		return ScoreArea();
+	}
+
+	template <typename Geometry>
+	double BasicBoard<Geometry>::ScoreArea() const {
+		// Every stone counts, and each empty region counts for a color if only that color
+		// borders it. Filling out from each color's stones through the empty points finds every
+		// region it borders at once.
+		std::pair<int, int> territory = CountTerritory(_black, _white, Empty(), _geometry.Stride());
+		return (_whiteStones + territory.second) - (_blackStones + territory.first) + GetKomi();
+	}
+
+	template <typename Geometry>
+	int BasicBoard<Geometry>::GetLiberties(const Grid2& position) const {
+		if (!IsWithinBoard(position) || GetTile(position) == Color::None) {
+			return -1;
+		} else {
+			return LibertyCount(_groupOf[ToIndex(position)]);
+		}
+	}
+
+	template <typename Geometry>
+	std::vector<Grid2> BasicBoard<Geometry>::GetGroup(const Grid2& position) const {
+		if (IsWithinBoard(position) && GetTile(position) != Color::None) {
+			int group = _groupOf[ToIndex(position)];
+			std::vector<Grid2> tiles;
+			tiles.reserve(_groupSize[group]);
+			int stone = group;
+			do {
+				tiles.push_back(ToGrid2(stone));
+				stone = _nextStone[stone];
+			} while (stone != group);
+			return tiles;
+		} else {
+			return std::vector<Grid2>();
+		}
+	}
+
+	template <typename Geometry>
+	int BasicBoard<Geometry>::GetGroupLiberties(const std::vector<Grid2>& group) const {
+		if (group.size() == 0) {
+			return 0;
+		} else {
+			return GetLiberties(group[0]);
+		}
+	}
+
+	template <typename Geometry>
+	std::vector<std::pair<Grid2, Grid2>> BasicBoard<Geometry>::GetAtariGroups(Color color) const {
+		std::vector<std::pair<Grid2, Grid2>> groups;
+		(_atari & Stones(color)).ForEach([&](int group) {
+			int liberty;
+			FindLiberties(group, &liberty, 1);
+			groups.emplace_back(ToGrid2(group), ToGrid2(liberty));
+		});
+		return groups;
+	}
+	template <typename Geometry>
+	std::vector<Grid2> BasicBoard<Geometry>::GetAdjacentGroups(const Grid2& position) const {
+		std::vector<Grid2> groups;
+		if (GetTile(position) != Color::None) {
+			ForEachAdjacentGroup(_groupOf[ToIndex(position)], [&](int group) {
+				groups.push_back(ToGrid2(group));
+			});
+		}
+		return groups;
+	}
+
+	template <typename Geometry>
+	int BasicBoard<Geometry>::GetSharedLiberties(const Grid2& a, const Grid2& b) const {
+		if (GetTile(a) == Color::None || GetTile(b) == Color::None) {
+			return 0;
+		}
+		return (_liberties[_groupOf[ToIndex(a)]] & _liberties[_groupOf[ToIndex(b)]]).Count();
+	}
+
+
+	template <typename Geometry>
+	bool BasicBoard<Geometry>::IsLadderCaptured(const Grid2& position) {
+		if (!IsWithinBoard(position) || GetTile(position) == Color::None) {
+			return false;
+		}
+		int index = ToIndex(position);
+		if (LibertyCount(_groupOf[index]) == 1) {
+			return LadderDefend(index, LADDER_MAX_DEPTH);
+		}
+		return LadderAttack(index, LADDER_MAX_DEPTH);
+	}
+
+	template <typename Geometry>
+	void BasicBoard<Geometry>::NextTurn() {
+		_hash ^= Zobrist().whiteToMove;
+		++_turnCount;
+		_whoseTurn = _whoseTurn == Color::Black ? Color::White : Color::Black;
+	}
+
+	template <typename Geometry>
+	void BasicBoard<Geometry>::UndoMove() {
+		if (_undoLog.empty()) {
+			throw std::runtime_error("Board tried to undo a move but there are none left to undo.");
+		}
+		UndoEntry entry = _undoLog.back();
+		_undoLog.pop_back();
+		int capturesEnd = static_cast<int>(_capturedStones.size());
+
+		if (entry.index != -1) {
+			int index = entry.index;
+			Color color = entry.color;
+			Color enemyColor = color == Color::Black ? Color::White : Color::Black;
+
+			// Superko is only recorded for positions after a stone, not after a pass.
+			auto seen = std::lower_bound(_positionHashes.begin(), _positionHashes.end(), GetPositionHash());
+			if (seen != _positionHashes.end() && *seen == GetPositionHash()) {
+				_positionHashes.erase(seen);
+			}
+
+			// Take the group the stone ended up in apart, then lift the stone itself.
+			int stones[MAX_POINTS];
+			int numStones = 0;
+			int group = _groupOf[index];
+			_atari.Reset(group);
+			_twoLiberties.Reset(group);
+			int stone = group;
+			do {
+				int next = _nextStone[stone];
+				if (stone != index) {
+					stones[numStones++] = stone;
+				}
+				_oneLibertyStones.Reset(stone);
+				_twoLibertyStones.Reset(stone);
+				_groupOf[stone] = -1;
+				_nextStone[stone] = -1;
+				stone = next;
+			} while (stone != group);
+			Stones(color).Reset(index);
+			ToggleSymmetryKeys(index, color);
+			_tiles[index] = Tile::None;
+			--StoneCount(color);
+			AddEmpty(index);
+
+			// Enemy groups that survived get their liberty back.
+			ForEachNeighbor(index, [&](int neighbor) {
+				if (_tiles[neighbor] == ToTile(enemyColor)) {
+					AddLiberty(_groupOf[neighbor], index);
+				}
+			});
+
+			// Put the captured stones back. Each captured group's only liberty was the point
+			// that was just played, and each stone takes a liberty from the groups around it.
+			for (int i = entry.capturesBegin; i < capturesEnd; ++i) {
+				Stones(enemyColor).Set(_capturedStones[i]);
+				ToggleSymmetryKeys(_capturedStones[i], enemyColor);
+				_tiles[_capturedStones[i]] = ToTile(enemyColor);
+				++StoneCount(enemyColor);
+				RemoveEmpty(_capturedStones[i]);
+			}
+			PointSet lastLiberty;
+			lastLiberty.Set(index);
+			for (int i = entry.capturesBegin; i < capturesEnd; ++i) {
+				if (_groupOf[_capturedStones[i]] == -1) {
+					SetLiberties(BuildGroup(_capturedStones[i], enemyColor), lastLiberty);
+				}
+			}
+			for (int i = entry.capturesBegin; i < capturesEnd; ++i) {
+				ForEachNeighbor(_capturedStones[i], [&](int neighbor) {
+					int neighborGroup = _groupOf[neighbor];
+					// Stones of the lifted group have no group until they are rebuilt below.
+					if (neighborGroup != -1 && _tiles[neighbor] == ToTile(color)) {
+						RemoveLiberty(neighborGroup, _capturedStones[i]);
+					}
+				});
+			}
+			(color == Color::Black ? _blackPiecesTaken : _whitePiecesTaken) -= capturesEnd - entry.capturesBegin;
+			_capturedStones.resize(entry.capturesBegin);
+
+			// Whatever is left of the group splits back into the groups that were joined.
+			for (int i = 0; i < numStones; ++i) {
+				if (_groupOf[stones[i]] == -1) {
+					int rebuilt = BuildGroup(stones[i], color);
+					SetLiberties(rebuilt, FindLibertySet(rebuilt));
+				}
+			}
+		}
+
+		_history.pop_back();
+		_hash = entry.hash;
+		_koPoint = entry.koPoint;
+		_koColor = entry.koColor;
+		_whoseTurn = entry.whoseTurn;
+		_turnCount = entry.turnCount;
+	}
+
+	template <typename Geometry>
+	void BasicBoard<Geometry>::LoadPosition(const std::vector<std::vector<Color>>& layout, Color whoseTurn, int turnCount, const Grid2& koPoint, int blackPiecesTaken, int whitePiecesTaken, const std::vector<MoveHistoryEntry>& recentMoves) {
+		Grid2 dimensions = GetDimensions();
+		if (static_cast<int>(layout.size()) != dimensions.X() || std::any_of(layout.begin(), layout.end(), [&](const std::vector<Color>& column) { return static_cast<int>(column.size()) != dimensions.Y(); })) {
+			throw std::invalid_argument("Board tried to load a layout that is the wrong size.");
+		}
+
+		// Start from an empty board and put the stones straight down, without any captures.
+		BasicBoard loaded(_geometry);
+		loaded._komi = _komi;
+		for (int x = 0; x < dimensions.X(); ++x) {
+			for (int y = 0; y < dimensions.Y(); ++y) {
+				Color color = layout[x][y];
+				if (color != Color::None) {
+					int index = loaded.ToIndex(Grid2(x, y));
+					loaded.Stones(color).Set(index);
+					loaded._tiles[index] = ToTile(color);
+					++loaded.StoneCount(color);
+					loaded.RemoveEmpty(index);
+					loaded._hash ^= StoneKey(index, color);
+					loaded.ToggleSymmetryKeys(index, color);
+				}
+			}
+		}
+		(loaded._black | loaded._white).ForEach([&](int index) {
+			if (loaded._groupOf[index] == -1) {
+				int group = loaded.BuildGroup(index, static_cast<Color>(loaded._tiles[index]));
+				loaded.SetLiberties(group, loaded.FindLibertySet(group));
+				if (loaded.LibertyCount(group) == 0) {
+					throw std::invalid_argument("Board tried to load a layout with a group that has no liberties.");
+				}
+			}
+		});
+
+		loaded._whoseTurn = whoseTurn;
+		if (whoseTurn == Color::White) {
+			loaded._hash ^= Zobrist().whiteToMove;
+		}
+		loaded._turnCount = turnCount;
+		loaded._blackPiecesTaken = blackPiecesTaken;
+		loaded._whitePiecesTaken = whitePiecesTaken;
+		if (koPoint != PASS) {
+			loaded._koPoint = loaded.ToIndex(koPoint);
+			loaded._koColor = whoseTurn;
+		}
+		loaded._positionHashes.clear();
+		loaded._positionFilter = BasicBitboard<POSITION_FILTER_WORDS>();
+		loaded.RecordPosition();
+		loaded._history = recentMoves;
+		*this = std::move(loaded);
+	}
+
+	template <typename Geometry>
+	bool BasicBoard<Geometry>::CanUndo() const {
+		return !_undoLog.empty();
+	}
+
+	template <typename Geometry>
+	void BasicBoard<Geometry>::RewindBoard(int numTurns) {
+		for (int i = 0; i < numTurns && !_undoLog.empty(); ++i) {
+			UndoMove();
+		}
+	}
+
+	template <typename Geometry>
+	BasicBoard<Geometry> BasicBoard<Geometry>::GetPreviousState(int numTurns) const {
+		BasicBoard newBoard(*this);
+		newBoard.RewindBoard(numTurns);
+		return newBoard;
+	}
+
+	template <typename Geometry>
+	std::vector<std::vector<Color>> BasicBoard<Geometry>::GetPreviousLayout(int numTurns) const {
+		// Walk the log backwards, lifting each placed stone and putting back what it captured.
+		std::vector<std::vector<Color>> layout = ToLayout(_black, _white);
+		int capturesEnd = static_cast<int>(_capturedStones.size());
+		for (int i = static_cast<int>(_undoLog.size()) - 1; i >= 0 && i >= static_cast<int>(_undoLog.size()) - numTurns; --i) {
+			const UndoEntry& entry = _undoLog[i];
+			if (entry.index != -1) {
+				Grid2 g = ToGrid2(entry.index);
+				layout[g.X()][g.Y()] = Color::None;
+				for (int c = entry.capturesBegin; c < capturesEnd; ++c) {
+					Grid2 captured = ToGrid2(_capturedStones[c]);
+					layout[captured.X()][captured.Y()] = entry.color == Color::Black ? Color::White : Color::Black;
+				}
+			}
+			capturesEnd = entry.capturesBegin;
+		}
+		return layout;
+	}
+
+	template <typename Geometry>
+	std::vector<MoveHistoryEntry> BasicBoard<Geometry>::GetHistory() const {
+		return _history;
+	}
+
+	template <typename Geometry>
+	int BasicBoard<Geometry>::GetConsecutivePasses() const {
+		int passes = 0;
+		for (auto it = _history.rbegin(); it != _history.rend() && it->GetPosition() == PASS; ++it) {
+			++passes;
+		}
+		return passes;
+	}
+
+	template <typename Geometry>
+	uint64_t BasicBoard<Geometry>::GetHash() const {
+		return _hash;
+	}
+
+	template <typename Geometry>
+	uint64_t BasicBoard<Geometry>::GetPositionHash() const {
+		return _whoseTurn == Color::White ? _hash ^ Zobrist().whiteToMove : _hash;
+	}
+
+	template <typename Geometry>
+	uint64_t BasicBoard<Geometry>::GetSymmetryHash(int transform) const {
+		return _symmetryHashes[transform];
+	}
+
+	template <typename Geometry>
+	uint64_t BasicBoard<Geometry>::GetCanonicalHash() const {
+		uint64_t hash = _symmetryHashes[GetCanonicalTransform()];
+		return _whoseTurn == Color::White ? hash ^ Zobrist().whiteToMove : hash;
+	}
+
+	template <typename Geometry>
+	int BasicBoard<Geometry>::GetCanonicalTransform() const {
+		int best = 0;
+		for (int t = 1; t < SYMMETRY_COUNT; ++t) {
+			if (IsSymmetryOf(t, GetDimensions()) && _symmetryHashes[t] < _symmetryHashes[best]) {
+				best = t;
+			}
+		}
+		return best;
+	}
+
+	template <typename Geometry>
+	Grid2 BasicBoard<Geometry>::GetKoPoint() const {
+		return _koPoint == -1 ? PASS : ToGrid2(_koPoint);
+	}
+
+	template <typename Geometry>
+	int BasicBoard<Geometry>::GetBlackPiecesTaken() const {
+		return _blackPiecesTaken;
+	}
+
+	template <typename Geometry>
+	int BasicBoard<Geometry>::GetWhitePiecesTaken() const {
+		return _whitePiecesTaken;
+	}
+
+	template <typename Geometry>
+	const Geometry& BasicBoard<Geometry>::GetGeometry() const {
+		return _geometry;
+	}
+
+	template <typename Geometry>
+	int BasicBoard<Geometry>::PositionFilterBit(uint64_t positionHash) {
+		return static_cast<int>(positionHash >> 52) & (POSITION_FILTER_WORDS * 64 - 1);
+	}
+
+	template <typename Geometry>
+	void BasicBoard<Geometry>::RecordPosition() {
+		uint64_t hash = GetPositionHash();
+		_positionHashes.insert(std::lower_bound(_positionHashes.begin(), _positionHashes.end(), hash), hash);
+		_positionFilter.Set(PositionFilterBit(hash));
+	}
+
+	template <typename Geometry>
+	int BasicBoard<Geometry>::ToIndex(const Grid2& position) const {
+		return (position.Y() + 1) * _geometry.Stride() + position.X() + 1;
+	}
+
+	template <typename Geometry>
+	Grid2 BasicBoard<Geometry>::ToGrid2(int index) const {
+		return Grid2(index % _geometry.Stride() - 1, index / _geometry.Stride() - 1);
+	}
+
+	template <typename Geometry>
+	typename BasicBoard<Geometry>::PointSet& BasicBoard<Geometry>::Stones(Color color) {
+		return color == Color::Black ? _black : _white;
+	}
+
+	template <typename Geometry>
+	const typename BasicBoard<Geometry>::PointSet& BasicBoard<Geometry>::Stones(Color color) const {
+		return color == Color::Black ? _black : _white;
+	}
+
+	template <typename Geometry>
+	int& BasicBoard<Geometry>::StoneCount(Color color) {
+		return color == Color::Black ? _blackStones : _whiteStones;
+	}
+
+	template <typename Geometry>
+	typename BasicBoard<Geometry>::PointSet BasicBoard<Geometry>::Empty() const {
+		return _onBoard & ~(_black | _white);
+	}
+
+	template <typename Geometry>
+	void BasicBoard<Geometry>::AddEmpty(int index) {
+		_emptyPosition[index] = _numEmpty;
+		_emptyPoints[_numEmpty++] = index;
+	}
+
+	template <typename Geometry>
+	void BasicBoard<Geometry>::RemoveEmpty(int index) {
+		// The last point in the list takes the removed one's place.
+		int last = _emptyPoints[--_numEmpty];
+		_emptyPoints[_emptyPosition[index]] = last;
+		_emptyPosition[last] = _emptyPosition[index];
+		_emptyPosition[index] = -1;
+	}
+
+	template <typename Geometry>
+	bool BasicBoard<Geometry>::IsLegal(int index, Color color) const {
+		if (_tiles[index] != Tile::None || IsKo(index, color)) {
+			return false;
+		}
+
+		// This is IsSuicide and PositionHashAfter in a single pass over the neighbours, since
+		// every empty point goes through here when listing the valid moves.
+		const ZobristKeys& keys = Zobrist();
+		Color enemyColor = color == Color::Black ? Color::White : Color::Black;
+		uint64_t hash = GetPositionHash() ^ StoneKey(index, color);
+		bool safe = false;
+		int captured[4];
+		int numCaptured = 0;
+		ForEachNeighbor(index, [&](int neighbor) {
+			Tile tile = _tiles[neighbor];
+			int group = _groupOf[neighbor];
+			if (tile == Tile::None) {
+				safe = true;
+			} else if (tile == ToTile(color)) {
+				safe = safe || LibertyCount(group) > 1;
+			} else if (tile != Tile::Edge && LibertyCount(group) == 1 && std::find(captured, captured + numCaptured, group) == captured + numCaptured) {
+				safe = true;
+				captured[numCaptured++] = group;
+				int stone = group;
+				do {
+					hash ^= keys.stones[enemyColor == Color::Black ? 0 : 1][stone];
+					stone = _nextStone[stone];
+				} while (stone != group);
+			}
+		});
+		return safe && !IsPositionSeen(hash);
+	}
+
+	template <typename Geometry>
+	typename BasicBoard<Geometry>::PointSet BasicBoard<Geometry>::LegalPoints(Color color) const {
+		int stride = _geometry.Stride();
+		const PointSet& friendly = Stones(color);
+		const PointSet& enemy = Stones(color == Color::Black ? Color::White : Color::Black);
+		PointSet empty = Empty();
+
+		// A point next to a friendly group with another liberty is safe, and so is the last
+		// liberty of an enemy group, since playing there captures it.
+		PointSet friendlyAtari = _atari & friendly;
+		PointSet safeFriends = friendly;
+		if (friendlyAtari.Any()) {
+			safeFriends &= ~FloodFill(friendlyAtari, friendly, stride);
+		}
+		PointSet captures;
+		(_atari & enemy).ForEach([&](int group) {
+			captures |= _liberties[group];
+		});
+		PointSet candidates = empty & (empty.Neighbors(stride) | safeFriends.Neighbors(stride) | captures);
+		if (_koPoint >= 0 && _koColor == color) {
+			candidates.Reset(_koPoint);
+		}
+
+		// Only a capture needs its groups walked to find the position it leads to.
+		PointSet legal = candidates;
+		uint64_t hash = GetPositionHash();
+		(candidates & ~captures).ForEach([&](int index) {
+			if (IsPositionSeen(hash ^ StoneKey(index, color))) {
+				legal.Reset(index);
+			}
+		});
+		(candidates & captures).ForEach([&](int index) {
+			if (IsSuperko(index, color)) {
+				legal.Reset(index);
+			}
+		});
+		return legal;
+	}
+
+	template <typename Geometry>
+	bool BasicBoard<Geometry>::IsKo(int index, Color color) const {
+		return index == _koPoint && color == _koColor;
+	}
+
+	template <typename Geometry>
+	bool BasicBoard<Geometry>::IsSuperko(int index, Color color) const {
+		return IsPositionSeen(PositionHashAfter(index, color));
+	}
+
+	template <typename Geometry>
+	bool BasicBoard<Geometry>::IsPositionSeen(uint64_t positionHash) const {
+		return _positionFilter.Test(PositionFilterBit(positionHash)) && std::binary_search(_positionHashes.begin(), _positionHashes.end(), positionHash);
+	}
+
+	template <typename Geometry>
+	bool BasicBoard<Geometry>::IsSuicide(int index, Color color) const {
+		// The stone would breathe through its empty neighbours and every liberty of the friendly
+		// groups it joins, other than the point itself. Even with none of those, taking an enemy
+		// group's last liberty captures it and frees some up.
+		PointSet liberties;
+		bool captures = false;
+		ForEachNeighbor(index, [&](int neighbor) {
+			Tile tile = _tiles[neighbor];
+			if (tile == Tile::None) {
+				liberties.Set(neighbor);
+			} else if (tile == ToTile(color)) {
+				liberties |= _liberties[_groupOf[neighbor]];
+			} else if (tile != Tile::Edge) {
+				captures = captures || LibertyCount(_groupOf[neighbor]) == 1;
+			}
+		});
+		liberties.Reset(index);
+		return liberties.None() && !captures;
+	}
+
+	template <typename Geometry>
+	void BasicBoard<Geometry>::ToggleSymmetryKeys(int index, Color color) {
+		// Each transform hashes the stone where it would land on the transformed board, using
+		// that board's padded indices. This is TransformPoint written out for every transform,
+		// since it runs for every stone placed or taken.
+		const uint64_t* keys = Zobrist().stones[color == Color::Black ? 0 : 1];
+		int width = _geometry.Width();
+		int height = _geometry.Height();
+		int xs[2] = {index % _geometry.Stride() - 1, 0};
+		int ys[2] = {index / _geometry.Stride() - 1, 0};
+		xs[1] = width - 1 - xs[0];
+		ys[1] = height - 1 - ys[0];
+		for (int t = 0; t < 4; ++t) {
+			_symmetryHashes[t] ^= keys[(ys[t >> 1] + 1) * (width + 1) + xs[t & 1] + 1];
+			_symmetryHashes[t + 4] ^= keys[(xs[t >> 1] + 1) * (height + 1) + ys[t & 1] + 1];
+		}
+	}
+
+	template <typename Geometry>
+	bool BasicBoard<Geometry>::IsTrueEye(int index, Color color) const {
+		if (_tiles[index] != Tile::None) {
+			return false;
+		}
+		Tile friendly = ToTile(color);
+		bool surrounded = true;
+		ForEachNeighbor(index, [&](int neighbor) {
+			surrounded = surrounded && (_tiles[neighbor] == friendly || _tiles[neighbor] == Tile::Edge);
+		});
+		if (!surrounded) {
+			return false;
+		}
+
+		// An enemy stone on a diagonal can cut the eye off. One is fine in the middle of the
+		// board, but on the edge there's no room for any.
+		int enemyDiagonals = 0;
+		bool onEdge = false;
+		for (int offset : _geometry.DiagonalOffsets()) {
+			Tile tile = _tiles[index + offset];
+			if (tile == Tile::Edge) {
+				onEdge = true;
+			} else if (tile != friendly && tile != Tile::None) {
+				++enemyDiagonals;
+			}
+		}
+		return enemyDiagonals + (onEdge ? 1 : 0) < 2;
+	}
+
+	template <typename Geometry>
+	uint64_t BasicBoard<Geometry>::PositionHashAfter(int index, Color color) const {
+		uint64_t hash = GetPositionHash() ^ StoneKey(index, color);
+		Color enemyColor = color == Color::Black ? Color::White : Color::Black;
+		int captured[4];
+		int numCaptured = 0;
+		ForEachNeighbor(index, [&](int neighbor) {
+			int group = _groupOf[neighbor];
+			if (_tiles[neighbor] == ToTile(enemyColor) && LibertyCount(group) == 1 && std::find(captured, captured + numCaptured, group) == captured + numCaptured) {
+				captured[numCaptured++] = group;
+				int stone = group;
+				do {
+					hash ^= StoneKey(stone, enemyColor);
+					stone = _nextStone[stone];
+				} while (stone != group);
+			}
+		});
+		return hash;
+	}
+
+	template <typename Geometry>
+	int BasicBoard<Geometry>::MergeGroups(int a, int b) {
+		if (a == b) {
+			return a;
+		}
+		// The smaller group is relabelled, so the cost is proportional to the stones moved.
+		if (_groupSize[a] < _groupSize[b]) {
+			std::swap(a, b);
+		}
+		PointSet moved;
+		int stone = b;
+		do {
+			_groupOf[stone] = a;
+			moved.Set(stone);
+			stone = _nextStone[stone];
+		} while (stone != b);
+		// The relabelled stones go on a's liberty plane, until the joined group's liberties are set.
+		UpdateLibertyPlanes(a, moved);
+		// Splicing two circular lists together is just a swap of their successors.
+		std::swap(_nextStone[a], _nextStone[b]);
+		_groupSize[a] += _groupSize[b];
+		_atari.Reset(b);
+		_twoLiberties.Reset(b);
+		return a;
+	}
+
+	template <typename Geometry>
+	typename BasicBoard<Geometry>::PointSet BasicBoard<Geometry>::FindLibertySet(int group) const {
+		PointSet liberties;
+		int stone = group;
+		do {
+			ForEachNeighbor(stone, [&](int neighbor) {
+				liberties.Set(neighbor);
+			});
+			stone = _nextStone[stone];
+		} while (stone != group);
+		return liberties & Empty();
+	}
+
+	template <typename Geometry>
+	int BasicBoard<Geometry>::LibertyCount(int group) const {
+		return _libertyCount[group];
+	}
+
+	template <typename Geometry>
+	void BasicBoard<Geometry>::SetLiberties(int group, const PointSet& liberties) {
+		_liberties[group] = liberties;
+		_libertyCount[group] = liberties.Count();
+		UpdateAtari(group);
+	}
+
+	template <typename Geometry>
+	void BasicBoard<Geometry>::AddLiberty(int group, int index) {
+		if (!_liberties[group].Test(index)) {
+			_liberties[group].Set(index);
+			++_libertyCount[group];
+			UpdateAtari(group);
+		}
+	}
+
+	template <typename Geometry>
+	void BasicBoard<Geometry>::RemoveLiberty(int group, int index) {
+		if (_liberties[group].Test(index)) {
+			_liberties[group].Reset(index);
+			--_libertyCount[group];
+			UpdateAtari(group);
+		}
+	}
+
+	template <typename Geometry>
+	void BasicBoard<Geometry>::UpdateAtari(int group) {
+		bool wasAtari = _atari.Test(group);
+		bool wasTwoLiberties = _twoLiberties.Test(group);
+		if (LibertyCount(group) == 1) {
+			_atari.Set(group);
+		} else {
+			_atari.Reset(group);
+		}
+		if (LibertyCount(group) == 2) {
+			_twoLiberties.Set(group);
+		} else {
+			_twoLiberties.Reset(group);
+		}
+
+		// Only a group moving between the liberty planes touches its stones. A group that has
+		// just been captured has none left.
+		if ((_atari.Test(group) == wasAtari && _twoLiberties.Test(group) == wasTwoLiberties) || _groupSize[group] == 0) {
+			return;
+		}
+		PointSet stones;
+		int stone = group;
+		do {
+			stones.Set(stone);
+			stone = _nextStone[stone];
+		} while (stone != group);
+		UpdateLibertyPlanes(group, stones);
+	}
+
+	template <typename Geometry>
+	void BasicBoard<Geometry>::UpdateLibertyPlanes(int group, const PointSet& stones) {
+		_oneLibertyStones &= ~stones;
+		_twoLibertyStones &= ~stones;
+		if (_atari.Test(group)) {
+			_oneLibertyStones |= stones;
+		} else if (_twoLiberties.Test(group)) {
+			_twoLibertyStones |= stones;
+		}
+	}
+
+	template <typename Geometry>
+	int BasicBoard<Geometry>::FindLiberties(int group, int* liberties, int max) const {
+		int found = 0;
+		PointSet remaining = _liberties[group];
+		while (found < max && remaining.Any()) {
+			liberties[found] = remaining.First();
+			remaining.Reset(liberties[found++]);
+		}
+		return found;
+	}
+	template <typename Geometry>
+	template <typename F>
+	void BasicBoard<Geometry>::ForEachAdjacentGroup(int group, F f) const {
+		Color enemyColor = _tiles[group] == Tile::Black ? Color::White : Color::Black;
+		PointSet seen;
+		(_outline[group] & Stones(enemyColor)).ForEach([&](int stone) {
+			int neighborGroup = _groupOf[stone];
+			if (!seen.Test(neighborGroup)) {
+				seen.Set(neighborGroup);
+				f(neighborGroup);
+			}
+		});
+	}
+
+
+	template <typename Geometry>
+	bool BasicBoard<Geometry>::LadderDefend(int stone, int depth) {
+		if (depth <= 0) {
+			return false;
+		}
+		Color color = static_cast<Color>(_tiles[stone]);
+		int group = _groupOf[stone];
+
+		// The group can run out through its last liberty, or capture one of the stones around it
+		// that is itself in atari.
+		int escapes[MAX_POINTS];
+		int numEscapes = FindLiberties(group, escapes, 1);
+		ForEachAdjacentGroup(group, [&](int neighborGroup) {
+			if (LibertyCount(neighborGroup) == 1) {
+				int liberty;
+				FindLiberties(neighborGroup, &liberty, 1);
+				if (std::find(escapes, escapes + numEscapes, liberty) == escapes + numEscapes) {
+					escapes[numEscapes++] = liberty;
+				}
+			}
+		});
+
+		for (int i = 0; i < numEscapes; ++i) {
+			if (IsLegal(escapes[i], color)) {
+				PlacePiece(ToGrid2(escapes[i]), color);
+				bool captured = LadderAttack(stone, depth - 1);
+				UndoMove();
+				if (!captured) {
+					return false;
+				}
+			}
+		}
+		return true;
+	}
+
+	template <typename Geometry>
+	bool BasicBoard<Geometry>::LadderAttack(int stone, int depth) {
+		int group = _groupOf[stone];
+		int liberties = LibertyCount(group);
+		if (liberties == 1) {
+			return true;
+		}
+		if (liberties > 2 || depth <= 0) {
+			return false;
+		}
+		Color enemyColor = _tiles[stone] == Tile::Black ? Color::White : Color::Black;
+		int ataris[2];
+		FindLiberties(group, ataris, 2);
+		for (int i = 0; i < 2; ++i) {
+			if (IsLegal(ataris[i], enemyColor)) {
+				PlacePiece(ToGrid2(ataris[i]), enemyColor);
+				bool captured = LibertyCount(_groupOf[stone]) == 1 && LadderDefend(stone, depth - 1);
+				UndoMove();
+				if (captured) {
+					return true;
+				}
+			}
+		}
+		return false;
+	}
+
+	template <typename Geometry>
+	int BasicBoard<Geometry>::BuildGroup(int seed, Color color) {
+		// A depth-first walk over connected stones of the color that don't have a group yet.
+		int stack[MAX_POINTS];
+		int stackSize = 0;
+		stack[stackSize++] = seed;
+		_groupOf[seed] = seed;
+		_nextStone[seed] = seed;
+		_groupSize[seed] = 1;
+		PointSet outline;
+		while (stackSize > 0) {
+			int stone = stack[--stackSize];
+			ForEachNeighbor(stone, [&](int neighbor) {
+				outline.Set(neighbor);
+				if (_groupOf[neighbor] == -1 && _tiles[neighbor] == ToTile(color)) {
+					_groupOf[neighbor] = seed;
+					_nextStone[neighbor] = _nextStone[seed];
+					_nextStone[seed] = neighbor;
+					++_groupSize[seed];
+					stack[stackSize++] = neighbor;
+				}
+			});
+		}
+		_outline[seed] = outline & _onBoard & ~Stones(color);
+		return seed;
+	}
+
+	template <typename Geometry>
+	int BasicBoard<Geometry>::RemoveGroup(int group, Color color) {
+		int removed = _groupSize[group];
+		PointSet& stones = Stones(color);
+		int stone = group;
+		do {
+			int next = _nextStone[stone];
+			stones.Reset(stone);
+			_oneLibertyStones.Reset(stone);
+			_twoLibertyStones.Reset(stone);
+			_tiles[stone] = Tile::None;
+			AddEmpty(stone);
+			_hash ^= StoneKey(stone, color);
+			ToggleSymmetryKeys(stone, color);
+			_capturedStones.push_back(stone);
+			_groupOf[stone] = -1;
+			_nextStone[stone] = -1;
+
+			// The emptied point becomes a liberty of each group around it.
+			ForEachNeighbor(stone, [&](int neighbor) {
+				int neighborGroup = _groupOf[neighbor];
+				if (neighborGroup != -1 && neighborGroup != group) {
+					AddLiberty(neighborGroup, stone);
+				}
+			});
+			stone = next;
+		} while (stone != group);
+		StoneCount(color) -= removed;
+		_groupSize[group] = 0;
+		SetLiberties(group, PointSet());
+		_outline[group] = PointSet();
+		return removed;
+	}
+
+	template <typename Geometry>
+	std::vector<std::vector<Color>> BasicBoard<Geometry>::ToLayout(const PointSet& black, const PointSet& white) const {
+		std::vector<std::vector<Color>> layout(GetDimensions().X(), std::vector<Color>(GetDimensions().Y(), Color::None));
+		black.ForEach([&](int index) {
+			Grid2 g = ToGrid2(index);
+			layout[g.X()][g.Y()] = Color::Black;
+		});
+		white.ForEach([&](int index) {
+			Grid2 g = ToGrid2(index);
+			layout[g.X()][g.Y()] = Color::White;
+		});
+		return layout;
+	}
+
+	template <typename Geometry>
+	constexpr int BasicBoard<Geometry>::RANDOM_MOVE_ATTEMPTS;
+
+	template class BasicBoard<FixedGeometry<9>>;
+	template class BasicBoard<FixedGeometry<13>>;
+	template class BasicBoard<FixedGeometry<19>>;
+	template class BasicBoard<DynamicGeometry>;
+}
\ No newline at end of file
@@ -1,434 +1,487 @@
 #include "Board.h"
 
-#include <functional>
-#include <queue>
-#include <set>
-#include <sstream>
-#include <stack>
-#include <stdexcept>
-
-#include <iostream>
+#include "BasicBoard.h"
 
 namespace BeitaGo {
-	Board::Board(const Grid2& dimensions) : _dimensions(dimensions), _groups{dimensions.Y(), std::vector<int>(dimensions.X(), -1)}, _liberties(dimensions.X() * dimensions.Y(), -1) {
-		_tiles = std::vector<std::vector<Color>>(dimensions.X(), std::vector<Color>(dimensions.Y(), Color::None));
-		_whoseTurn = Color::Black;
-		_blackPiecesTaken = 0;
-		_whitePiecesTaken = 0;
-		_turnCount = 1;
-		_komi = 6.5;
+	namespace {
+		/**
+		 * Lets BasicBoard::GetRandomValidMove draw from the function Board was given.
+		 */
+		struct RandomFunction {
+			const std::function<int(int)>& below;
+		};
+
+		int RandomBelow(RandomFunction& random, int n) {
+			return random.below(n);
+		}
+	}
+
+	/**
+	 * The interface every BasicBoard is wrapped in. It mirrors Board's public methods.
+	 */
+	class Board::Impl {
+		public:
+		virtual ~Impl() {}
+		virtual std::unique_ptr<Impl> Clone() const = 0;
+		virtual Grid2 GetDimensions() const = 0;
+		virtual Color GetTile(const Grid2& position) const = 0;
+		virtual Color GetWhoseTurn() const = 0;
+		virtual int GetTurnCount() const = 0;
+		virtual bool IsGameOver() const = 0;
+		virtual void PlacePiece(const Grid2& position, Color color) = 0;
+		virtual bool IsMoveValid(const Grid2& position, Color color) const = 0;
+		virtual bool IsMoveKo(const Grid2& position, Color color) const = 0;
+		virtual bool IsMoveSuperko(const Grid2& position, Color color) const = 0;
+		virtual bool IsMoveSuicidePlay(const Grid2& position, Color color) const = 0;
+		virtual bool IsEye(const Grid2& position, Color color) const = 0;
+		virtual bool IsWithinBoard(const Grid2& position) const = 0;
+		virtual std::vector<Grid2> GetValidMoves(const Color& color) const = 0;
+		virtual Bitboard LegalMask(Color color) const = 0;
+		virtual Bitboard GetStoneMask(Color color) const = 0;
+		virtual Bitboard GetFeaturePlane(FeaturePlane plane) const = 0;
+		virtual Grid2 RandomValidMove(const Color& color, const std::function<int(int)>& below) const = 0;
+		virtual int GetEmptyCount() const = 0;
+		virtual double GetKomi() const = 0;
+		virtual void SetKomi(double komi) = 0;
+		virtual double Score() const = 0;
+		virtual double ScoreArea() const = 0;
+		virtual int GetLiberties(const Grid2& position) const = 0;
+		virtual std::vector<Grid2> GetGroup(const Grid2& position) const = 0;
+		virtual int GetGroupLiberties(const std::vector<Grid2>& group) const = 0;
+		virtual std::vector<std::pair<Grid2, Grid2>> GetAtariGroups(Color color) const = 0;
+		virtual std::vector<Grid2> GetAdjacentGroups(const Grid2& position) const = 0;
+		virtual int GetSharedLiberties(const Grid2& a, const Grid2& b) const = 0;
+		virtual bool IsLadderCaptured(const Grid2& position) = 0;
+		virtual void NextTurn() = 0;
+		virtual void UndoMove() = 0;
+		virtual bool CanUndo() const = 0;
+		virtual void RewindBoard(int numTurns) = 0;
+		virtual std::vector<std::vector<Color>> GetPreviousLayout(int numTurns) const = 0;
+		virtual void LoadPosition(const std::vector<std::vector<Color>>& layout, Color whoseTurn, int turnCount, const Grid2& koPoint, int blackPiecesTaken, int whitePiecesTaken, const std::vector<MoveHistoryEntry>& recentMoves) = 0;
+		virtual std::vector<MoveHistoryEntry> GetHistory() const = 0;
+		virtual int GetConsecutivePasses() const = 0;
+		virtual uint64_t GetHash() const = 0;
+		virtual uint64_t GetPositionHash() const = 0;
+		virtual uint64_t GetSymmetryHash(int transform) const = 0;
+		virtual uint64_t GetCanonicalHash() const = 0;
+		virtual int GetCanonicalTransform() const = 0;
+		virtual Grid2 GetKoPoint() const = 0;
+		virtual int GetBlackPiecesTaken() const = 0;
+		virtual int GetWhitePiecesTaken() const = 0;
+	};
+
+	/**
+	 * Wraps a board of a particular geometry.
+	 */
+	template <typename B>
+	class Board::ImplFor : public Board::Impl {
+		public:
+		explicit ImplFor(const Grid2& dimensions) : _board(dimensions) {}
+
+		std::unique_ptr<Impl> Clone() const override {
+			return std::unique_ptr<Impl>(new ImplFor(*this));
+		}
+
+		Grid2 GetDimensions() const override {
+			return _board.GetDimensions();
+		}
+
+		Color GetTile(const Grid2& position) const override {
+			return _board.GetTile(position);
+		}
+
+		Color GetWhoseTurn() const override {
+			return _board.GetWhoseTurn();
+		}
+
+		int GetTurnCount() const override {
+			return _board.GetTurnCount();
+		}
+
+		bool IsGameOver() const override {
+			return _board.IsGameOver();
+		}
+
+		void PlacePiece(const Grid2& position, Color color) override {
+			_board.PlacePiece(position, color);
+		}
+
+		bool IsMoveValid(const Grid2& position, Color color) const override {
+			return _board.IsMoveValid(position, color);
+		}
+
+		bool IsMoveKo(const Grid2& position, Color color) const override {
+			return _board.IsMoveKo(position, color);
+		}
+
+		bool IsMoveSuperko(const Grid2& position, Color color) const override {
+			return _board.IsMoveSuperko(position, color);
+		}
+
+		bool IsMoveSuicidePlay(const Grid2& position, Color color) const override {
+			return _board.IsMoveSuicidePlay(position, color);
+		}
+
+		bool IsEye(const Grid2& position, Color color) const override {
+			return _board.IsEye(position, color);
+		}
+
+		bool IsWithinBoard(const Grid2& position) const override {
+			return _board.IsWithinBoard(position);
+		}
+
+		std::vector<Grid2> GetValidMoves(const Color& color) const override {
+			return _board.GetValidMoves(color);
+		}
+
+		Bitboard LegalMask(Color color) const override {
+			return _board.LegalMask(color);
+		}
+
+		Bitboard GetStoneMask(Color color) const override {
+			return _board.GetStoneMask(color);
+		}
+
+		Bitboard GetFeaturePlane(FeaturePlane plane) const override {
+			return _board.GetFeaturePlane(plane);
+		}
+
+		Grid2 RandomValidMove(const Color& color, const std::function<int(int)>& below) const override {
+			RandomFunction random{below};
+			return _board.GetRandomValidMove(color, random);
+		}
+
+		int GetEmptyCount() const override {
+			return _board.GetEmptyCount();
+		}
+
+		double GetKomi() const override {
+			return _board.GetKomi();
+		}
+
+		void SetKomi(double komi) override {
+			_board.SetKomi(komi);
+		}
+
+		double Score() const override {
+			return _board.Score();
+		}
+
+		double ScoreArea() const override {
+			return _board.ScoreArea();
+		}
+
+		int GetLiberties(const Grid2& position) const override {
+			return _board.GetLiberties(position);
+		}
+
+		std::vector<Grid2> GetGroup(const Grid2& position) const override {
+			return _board.GetGroup(position);
+		}
+
+		int GetGroupLiberties(const std::vector<Grid2>& group) const override {
+			return _board.GetGroupLiberties(group);
+		}
+
+		std::vector<std::pair<Grid2, Grid2>> GetAtariGroups(Color color) const override {
+			return _board.GetAtariGroups(color);
+		}
+
+		std::vector<Grid2> GetAdjacentGroups(const Grid2& position) const override {
+			return _board.GetAdjacentGroups(position);
+		}
+
+		int GetSharedLiberties(const Grid2& a, const Grid2& b) const override {
+			return _board.GetSharedLiberties(a, b);
+		}
+
+		bool IsLadderCaptured(const Grid2& position) override {
+			return _board.IsLadderCaptured(position);
+		}
+
+		void NextTurn() override {
+			_board.NextTurn();
+		}
+
+		void UndoMove() override {
+			_board.UndoMove();
+		}
+
+		bool CanUndo() const override {
+			return _board.CanUndo();
+		}
+
+		void RewindBoard(int numTurns) override {
+			_board.RewindBoard(numTurns);
+		}
+
+		std::vector<std::vector<Color>> GetPreviousLayout(int numTurns) const override {
+			return _board.GetPreviousLayout(numTurns);
+		}
+
+		void LoadPosition(const std::vector<std::vector<Color>>& layout, Color whoseTurn, int turnCount, const Grid2& koPoint, int blackPiecesTaken, int whitePiecesTaken, const std::vector<MoveHistoryEntry>& recentMoves) override {
+			_board.LoadPosition(layout, whoseTurn, turnCount, koPoint, blackPiecesTaken, whitePiecesTaken, recentMoves);
+		}
+
+		std::vector<MoveHistoryEntry> GetHistory() const override {
+			return _board.GetHistory();
+		}
+
+		int GetConsecutivePasses() const override {
+			return _board.GetConsecutivePasses();
+		}
+
+		uint64_t GetHash() const override {
+			return _board.GetHash();
+		}
+
+		uint64_t GetPositionHash() const override {
+			return _board.GetPositionHash();
+		}
+
+		uint64_t GetSymmetryHash(int transform) const override {
+			return _board.GetSymmetryHash(transform);
+		}
+
+		uint64_t GetCanonicalHash() const override {
+			return _board.GetCanonicalHash();
+		}
+
+		int GetCanonicalTransform() const override {
+			return _board.GetCanonicalTransform();
+		}
+
+		Grid2 GetKoPoint() const override {
+			return _board.GetKoPoint();
+		}
+
+		int GetBlackPiecesTaken() const override {
+			return _board.GetBlackPiecesTaken();
+		}
+
+		int GetWhitePiecesTaken() const override {
+			return _board.GetWhitePiecesTaken();
+		}
+
+		private:
+		B _board;
+	};
+
+	Board::Board(const Grid2& dimensions) {
+		// The standard square sizes get their own compiled boards, and anything else falls back
+		// to one sized at runtime.
+		if (dimensions == Grid2(9, 9)) {
+			_impl.reset(new ImplFor<FixedBoard<9>>(dimensions));
+		} else if (dimensions == Grid2(13, 13)) {
+			_impl.reset(new ImplFor<FixedBoard<13>>(dimensions));
+		} else if (dimensions == Grid2(19, 19)) {
+			_impl.reset(new ImplFor<FixedBoard<19>>(dimensions));
+		} else {
+			_impl.reset(new ImplFor<BasicBoard<DynamicGeometry>>(dimensions));
+		}
 	}
 
+	Board::Board(const Board& other) : _impl(other._impl->Clone()) {}
+
+	Board::Board(Board&& other) : _impl(std::move(other._impl)) {}
+
+	Board& Board::operator=(const Board& other) {
+		if (this != &other) {
+			_impl = other._impl->Clone();
+		}
+		return *this;
+	}
+
+	Board& Board::operator=(Board&& other) {
+		_impl = std::move(other._impl);
+		return *this;
+	}
+
+	Board::~Board() {}
+
 	Grid2 Board::GetDimensions() const {
-		return _dimensions;
+		return _impl->GetDimensions();
 	}
 
 	Color Board::GetTile(const Grid2& position) const {
-		//TODO: Error checking?
-		return _tiles[position.X()][position.Y()];
+		return _impl->GetTile(position);
 	}
 
 	Color Board::GetWhoseTurn() const {
-		return _whoseTurn;
+		return _impl->GetWhoseTurn();
 	}
 
 	int Board::GetTurnCount() const {
-		return _turnCount;
+		return _impl->GetTurnCount();
 	}
 
 	bool Board::IsGameOver() const {
-		return _history.size() >= 2 && (_history.end() - 2)->GetPosition() == PASS && (_history.end() - 1)->GetPosition() == PASS;
+		return _impl->IsGameOver();
 	}
 
 	void Board::PlacePiece(const Grid2& position, Color color) {
-		if (IsMoveValid(position, color)) {
-			_lastMoves.push_back(_tiles);
-			if (position != PASS) {
-				_tiles[position.X()][position.Y()] = color;
-				// Compute the number of liberties and neighbouring friendly tiles.
-				int additionalLiberties = 0;
-				int neighbouringFriendlies = 0;
-				Neighbors(position, [&](const Grid2& g) {
-					if (GetTile(g) == Color::None) {
-						++additionalLiberties;
-					} else if (GetTile(g) == color) {
-						++neighbouringFriendlies;
-					}
-				});
-
-				// Compute groups.
-				int foundGroup = -1;
-				Neighbors(position, [&](const Grid2& g) {
-					if (GetTile(g) == color) {
-						if (foundGroup == -1) {
-							// If we haven't yet found a neighbouring group, then let's take their
-							// group number. We can add the number of liberties of our tile to
-							// theirs (minus one because the tile itself takes a liberty).
-							foundGroup = _groups[g.X()][g.Y()];
-							_groups[position.X()][position.Y()] = foundGroup;
-							--additionalLiberties;
-							_liberties[foundGroup] += additionalLiberties;
-						} else if (_groups[g.X()][g.Y()] != foundGroup) {
-							// If we have found a group before AND this one is of a different group
-							// then we need to clear that group.
-							int groupToClear = _groups[g.X()][g.Y()];
-							int oldGroupLiberties = _liberties[groupToClear];
-							for (int x = 0; x < GetDimensions().X(); ++x) {
-								for (int y = 0; y < GetDimensions().Y(); ++y) {
-									if (_groups[x][y] == groupToClear) {
-										_groups[x][y] = foundGroup;
-									}
-								}
-							}
-							_liberties[foundGroup] += (oldGroupLiberties - 1);
-							_liberties[groupToClear] = -1;
-						} else {
-							// If we have found a group before AND this is the same group, then we
-							// cleared a liberty twice.
-							--_liberties[foundGroup];
-						}
-					} else if (GetTile(g) == (color == Color::Black ? Color::White : Color::Black)) {
-						// If the neighbouring tile is of another colour, their group will go down
-						// by one liberty.
-						int groupToSubtract = _groups[g.X()][g.Y()];
-						--_liberties[groupToSubtract];
-						// If their liberties is now zero
-						if (_liberties[groupToSubtract] == 0) {
-							int& points = (color == Color::Black ? _blackPiecesTaken : _whitePiecesTaken);
-							for (int x = 0; x < GetDimensions().X(); ++x) {
-								for (int y = 0; y < GetDimensions().Y(); ++y) {
-									if (_groups[x][y] == groupToSubtract) {
-										_tiles[x][y] = Color::None;
-										_groups[x][y] = -1;
-										++points;
-										Neighbors(Grid2(x, y), [this, groupToSubtract, &additionalLiberties, &position](const Grid2& g) {
-											if (_groups[g.X()][g.Y()] != -1 && _groups[g.X()][g.Y()] != groupToSubtract) {
-												++_liberties[_groups[g.X()][g.Y()]];
-											} else if (g == position) {
-												++additionalLiberties;
-											}
-										});
-									}
-								}
-							}
-							_liberties[groupToSubtract] = -1;
-						}
-					}
-				});
-
-				if (foundGroup == -1) {
-					for (int a = 0; a < _liberties.size(); ++a) {
-						if (_liberties[a] == -1) {
-							foundGroup = a;
-							break;
-						}
-					}
-					_groups[position.X()][position.Y()] = foundGroup;
-					_liberties[foundGroup] = additionalLiberties;
-				}
-
-				if (_liberties[foundGroup] == 0) {
-					int& points = (color == Color::Black ? _whitePiecesTaken : _blackPiecesTaken);
-					for (int x = 0; x < GetDimensions().X(); ++x) {
-						for (int y = 0; y < GetDimensions().Y(); ++y) {
-							if (_groups[x][y] == foundGroup) {
-								_tiles[x][y] = Color::None;
-								_groups[x][y] = -1;
-								++points;
-								Neighbors(Grid2(x, y), [this, foundGroup](const Grid2& g) {
-									if (_groups[g.X()][g.Y()] != -1 && _groups[g.X()][g.Y()] != foundGroup) {
-										++_liberties[_groups[g.X()][g.Y()]];
-									}
-								});
-							}
-						}
-					}
-					_liberties[foundGroup] = -1;
-				}
-			}
-			_history.emplace_back(position, color);
-			
-			/*
-			std::cout << "\n\n";
-
-			// First, print the top row.
-			std::cout << "+";
-			for (int x = 0; x < GetDimensions().X(); ++x) {
-				std::cout << "-";
-			}
-			std::cout << "+\n";
-
-			// Now, for each row, print the sides and any tiles.
-			for (int y = 0; y < GetDimensions().Y(); ++y) {
-				std::cout << "|";
-				for (int x = 0; x < GetDimensions().X(); ++x) {
-					std::cout << ((_groups[x][y] == -1) ? '.' : static_cast<char>(_groups[x][y] + '0'));
-				}
-				std::cout << "|\n";
-			}
-
-			// Finally print the bottom row.
-			std::cout << "+";
-			for (int x = 0; x < GetDimensions().X(); ++x) {
-				std::cout << "-";
-			}
-			std::cout << "+\n";
-
-			std::cout << "\n\n";
-
-			// First, print the top row.
-			std::cout << "+";
-			for (int x = 0; x < GetDimensions().X(); ++x) {
-				std::cout << "-";
-			}
-			std::cout << "+\n";
-
-			// Now, for each row, print the sides and any tiles.
-			for (int y = 0; y < GetDimensions().Y(); ++y) {
-				std::cout << "|";
-				for (int x = 0; x < GetDimensions().X(); ++x) {
-					std::cout << ((_groups[x][y] == -1) ? '.' : static_cast<char>(_liberties[_groups[x][y]] + '0'));
-				}
-				std::cout << "|\n";
-			}
-
-			// Finally print the bottom row.
-			std::cout << "+";
-			for (int x = 0; x < GetDimensions().X(); ++x) {
-				std::cout << "-";
-			}
-			std::cout << "+\n";
-			*/
-			
-			
-
-		} else {
-			std::stringstream s;
-			s << "Board tried to place a " << (color == Color::Black ? "BLACK" : "WHITE") << " piece at (" << position.X() << ", " << position.Y() << ") but it is invalid. Your AI or UI should check IsMoveValid() is true before calling PlacePiece() or ActDecision()!";
-			throw std::runtime_error(s.str());
-		}
+		_impl->PlacePiece(position, color);
 	}
 
 	bool Board::IsMoveValid(const Grid2& position, Color color) const {
-		if (position == PASS || (IsWithinBoard(position) && GetTile(position) == Color::None && !IsMoveSuicidePlay(position, color))) {
-			return true;
-		} else {
-			return false;
-		}
+		return _impl->IsMoveValid(position, color);
+	}
+
+	bool Board::IsMoveKo(const Grid2& position, Color color) const {
+		return _impl->IsMoveKo(position, color);
+	}
+
+	bool Board::IsMoveSuperko(const Grid2& position, Color color) const {
+		return _impl->IsMoveSuperko(position, color);
 	}
 
 	bool Board::IsMoveSuicidePlay(const Grid2& position, Color color) const {
-		int emptyNeighbors = 0;
-		bool safeFriendlyGroup = false;
-		Neighbors(position, [this, &emptyNeighbors, &safeFriendlyGroup, color](const Grid2& g) {
-			if (GetTile(g) == Color::None) {
-				++emptyNeighbors;
-			} else if (GetTile(g) == color && _liberties[_groups[g.X()][g.Y()]] > 1 || _liberties[_groups[g.X()][g.Y()]] == 1) {
-				safeFriendlyGroup = true;
-			}
-		});
-		return emptyNeighbors == 0 && !safeFriendlyGroup;
+		return _impl->IsMoveSuicidePlay(position, color);
+	}
+
+	bool Board::IsEye(const Grid2& position, Color color) const {
+		return _impl->IsEye(position, color);
 	}
 
 	bool Board::IsWithinBoard(const Grid2& position) const {
-		return position.X() >= 0 && position.X() < GetDimensions().X() && position.Y() >= 0 && position.Y() < GetDimensions().Y();
+		return _impl->IsWithinBoard(position);
 	}
 
 	std::vector<Grid2> Board::GetValidMoves(const Color& color) const {
-		//? While this may not scale that well, I think it'll be satisfactory for even the larger
-		//? board sizes people will use.
-		std::vector<Grid2> v;
-		v.reserve(GetDimensions().X() * GetDimensions().Y() + 1);
+		return _impl->GetValidMoves(color);
+	}
 
-		for (int y = 0; y < GetDimensions().Y(); ++y) {
-			for (int x = 0; x < GetDimensions().X(); ++x) {
-				if (IsMoveValid(Grid2(x, y), color)) {
-					v.emplace_back(x, y);
-				}
-			}
-		}
+	Bitboard Board::LegalMask(Color color) const {
+		return _impl->LegalMask(color);
+	}
 
-		v.push_back(PASS);
+	Bitboard Board::GetStoneMask(Color color) const {
+		return _impl->GetStoneMask(color);
+	}
+
+	Bitboard Board::GetFeaturePlane(FeaturePlane plane) const {
+		return _impl->GetFeaturePlane(plane);
+	}
 
-		return v;
+	Grid2 Board::RandomValidMove(const Color& color, const std::function<int(int)>& below) const {
+		return _impl->RandomValidMove(color, below);
+	}
+
+	int Board::GetEmptyCount() const {
+		return _impl->GetEmptyCount();
 	}
 
 	double Board::GetKomi() const {
-		return _komi;
+		return _impl->GetKomi();
 	}
 
 	void Board::SetKomi(double komi) {
-		_komi = komi;
+		_impl->SetKomi(komi);
 	}
 
 	double Board::Score() const {
-		return ScoreArea();
+		return _impl->Score();
 	}
 
 	double Board::ScoreArea() const {
-		std::vector<std::vector<Color>> workingBoard(_tiles);
-		std::vector<std::vector<bool>> seenTiles(GetDimensions().X(), std::vector<bool>(GetDimensions().Y(), false));
-		int blackTiles = 0;
-		int whiteTiles = 0;
-		for (int x = 0; x < GetDimensions().X(); ++x) {
-			for (int y = 0; y < GetDimensions().Y(); ++y) {
-				if (!seenTiles[x][y]) {
-					seenTiles[x][y] = true;
-					if (workingBoard[x][y] == Color::None) {
-						std::queue<Grid2> workingQueue;
-						std::vector<Grid2> seenSpaces;
-						workingQueue.push(Grid2(x, y));
-						seenSpaces.emplace_back(x, y);
-						bool seenBlack = false;
-						bool seenWhite = false;
-						while (!workingQueue.empty()) {
-							Grid2 currentSpace = workingQueue.front();
-							workingQueue.pop();
-							Neighbors(currentSpace, [&workingBoard, &workingQueue, &seenSpaces, &seenTiles, &seenWhite, &seenBlack](const Grid2& g) {
-								if (workingBoard[g.X()][g.Y()] == Color::None && !seenTiles[g.X()][g.Y()]) {
-									workingQueue.push(g);
-									seenTiles[g.X()][g.Y()] = true;
-									seenSpaces.push_back(g);
-								} else if (workingBoard[g.X()][g.Y()] == Color::White) {
-									seenWhite = true;
-								} else if (workingBoard[g.X()][g.Y()] == Color::Black) {
-									seenBlack = true;
-								}
-							});
-						}
-						if (seenBlack && !seenWhite) {
-							for (const Grid2& g : seenSpaces) {
-								workingBoard[g.X()][g.Y()] = Color::Black;
-								++blackTiles;
-							}
-						} else if (seenWhite && !seenBlack) {
-							for (const Grid2& g : seenSpaces) {
-								workingBoard[g.X()][g.Y()] = Color::White;
-								++whiteTiles;
-							}
-						}
-					} else if (workingBoard[x][y] == Color::Black) {
-						++blackTiles;
-					} else if (workingBoard[x][y] == Color::White) {
-						++whiteTiles;
-					}
-				}
-			}
-		}
-		return whiteTiles - blackTiles + GetKomi();
+		return _impl->ScoreArea();
 	}
 
 	int Board::GetLiberties(const Grid2& position) const {
-		if (!IsWithinBoard(position) || GetTile(position) == Color::None) {
-			return -1;
-		} else {
-			return _liberties[_groups[position.X()][position.Y()]];
-		}
+		return _impl->GetLiberties(position);
 	}
 
 	std::vector<Grid2> Board::GetGroup(const Grid2& position) const {
-		if (IsWithinBoard(position) && GetTile(position) != Color::None) {
-			int groupIndex = _groups[position.X()][position.Y()];
-			std::vector<Grid2> tiles;
-			tiles.reserve(GetDimensions().X() * GetDimensions().Y());
-			for (int x = 0; x < GetDimensions().X(); ++x) {
-				for (int y = 0; y < GetDimensions().Y(); ++y) {
-					if (_groups[x][y] == groupIndex) {
-						tiles.emplace_back(x, y);
-					}
-				}
-			}
-			return tiles;
-		} else {
-			return std::vector<Grid2>();
-		}
+		return _impl->GetGroup(position);
 	}
 
 	int Board::GetGroupLiberties(const std::vector<Grid2>& group) const {
-		if (group.size() == 0) {
-			return 0;
-		} else {
-			return GetLiberties(group[0]);
-		}
+		return _impl->GetGroupLiberties(group);
+	}
+
+	std::vector<std::pair<Grid2, Grid2>> Board::GetAtariGroups(Color color) const {
+		return _impl->GetAtariGroups(color);
+	}
+
+	std::vector<Grid2> Board::GetAdjacentGroups(const Grid2& position) const {
+		return _impl->GetAdjacentGroups(position);
+	}
+
+	int Board::GetSharedLiberties(const Grid2& a, const Grid2& b) const {
+		return _impl->GetSharedLiberties(a, b);
+	}
+
+	bool Board::IsLadderCaptured(const Grid2& position) {
+		return _impl->IsLadderCaptured(position);
 	}
 
 	void Board::NextTurn() {
-		++_turnCount;
-		_whoseTurn = _whoseTurn == Color::Black ? Color::White : Color::Black;
+		_impl->NextTurn();
 	}
 
-	void Board::RewindBoard(int numTurns) {
-		Board newBoard = GetPreviousState(numTurns);
-		this->_tiles = newBoard._tiles;
-		this->_history = newBoard._history;
-		this->_turnCount = newBoard._turnCount;
-		this->_whoseTurn = _whoseTurn;
+	void Board::UndoMove() {
+		_impl->UndoMove();
 	}
 
-	Board Board::GetPreviousState(int numTurns) const {
-		// For constant rewinds, this may not actually be efficient and the history should store
-		// the board placement instead.
-		if (numTurns <= 0) {
-			return *this;
-		}
-		Board newBoard(GetDimensions());
-		if (numTurns < _history.size()) {
-			for (auto it = _history.begin(); it != _history.begin() + (_history.size() - numTurns); ++it) {
-				newBoard.PlacePiece(it->GetPosition(), it->GetColor());
-				newBoard.NextTurn();
-			}
-		}
-		return newBoard;
+	bool Board::CanUndo() const {
+		return _impl->CanUndo();
+	}
+
+	void Board::RewindBoard(int numTurns) {
+		_impl->RewindBoard(numTurns);
 	}
 
 	std::vector<std::vector<Color>> Board::GetPreviousLayout(int numTurns) const {
-		if (numTurns <= 0 || numTurns >= _lastMoves.size()) {
-			return _tiles;
-		} else {
-			return _lastMoves[_lastMoves.size() - numTurns - 1];
-		}
+		return _impl->GetPreviousLayout(numTurns);
+	}
+
+	void Board::LoadPosition(const std::vector<std::vector<Color>>& layout, Color whoseTurn, int turnCount, const Grid2& koPoint, int blackPiecesTaken, int whitePiecesTaken, const std::vector<MoveHistoryEntry>& recentMoves) {
+		_impl->LoadPosition(layout, whoseTurn, turnCount, koPoint, blackPiecesTaken, whitePiecesTaken, recentMoves);
 	}
 
 	std::vector<MoveHistoryEntry> Board::GetHistory() const {
-		return _history;
+		return _impl->GetHistory();
 	}
 
-	int Board::GetBlackPiecesTaken() const {
-		return _blackPiecesTaken;
+	int Board::GetConsecutivePasses() const {
+		return _impl->GetConsecutivePasses();
 	}
 
-	int Board::GetWhitePiecesTaken() const {
-		return _whitePiecesTaken;
+	uint64_t Board::GetHash() const {
+		return _impl->GetHash();
 	}
 
-	void Board::ClearPossibleTiles(const Grid2& position) {
-		if (!IsWithinBoard(position)) {
-			return;
-		}
-		if (_liberties[_groups[position.X()][position.Y()]] == 0) {
-			for (const Grid2& space : GetGroup(position)) {
-				if (_tiles[space.X()][space.Y()] == Color::White) {
-					++_blackPiecesTaken;
-				} else if (_tiles[space.X()][space.Y()] == Color::Black) {
-					++_whitePiecesTaken;
-				}
-				_tiles[space.X()][space.Y()] = Color::None;
-			}
-		}
+	uint64_t Board::GetPositionHash() const {
+		return _impl->GetPositionHash();
 	}
 
-	inline void Board::Neighbors(const Grid2& g, std::function<void(const Grid2&)> f) const {
-		if (IsWithinBoard(g + Grid2(1, 0))) {
-			f(g + Grid2(1, 0));
-		}
-		if (IsWithinBoard(g + Grid2(0, 1))) {
-			f(g + Grid2(0, 1));
-		}
-		if (IsWithinBoard(g + Grid2(-1, 0))) {
-			f(g + Grid2(-1, 0));
-		}
-		if (IsWithinBoard(g + Grid2(0, -1))) {
-			f(g + Grid2(0, -1));
-		}
+	uint64_t Board::GetSymmetryHash(int transform) const {
+		return _impl->GetSymmetryHash(transform);
+	}
+
+	uint64_t Board::GetCanonicalHash() const {
+		return _impl->GetCanonicalHash();
+	}
+
+	int Board::GetCanonicalTransform() const {
+		return _impl->GetCanonicalTransform();
+	}
+
+	Grid2 Board::GetKoPoint() const {
+		return _impl->GetKoPoint();
+	}
+
+	int Board::GetBlackPiecesTaken() const {
+		return _impl->GetBlackPiecesTaken();
+	}
+
+	int Board::GetWhitePiecesTaken() const {
+		return _impl->GetWhitePiecesTaken();
+	}
+
+	Board Board::GetPreviousState(int numTurns) const {
+		Board newBoard(*this);
+		newBoard.RewindBoard(numTurns);
+		return newBoard;
 	}
-}
\ No newline at end of file
+}
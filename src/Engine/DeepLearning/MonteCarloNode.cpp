@@ -1,62 +1,62 @@
 #include "MonteCarloNode.h"
 
-#include <random>
-
 namespace BeitaGo {
-	MonteCarloNode::MonteCarloNode() : _board(Grid2(1, 1)), _lastMove(PASS), _valid(false), _totalWins(0), _totalSimulations(0) {
-	
+	constexpr uint32_t MonteCarloNode::NO_CHILDREN;
+	constexpr uint32_t MonteCarloNode::EXPANDING;
+
+	MonteCarloNode::MonteCarloNode() : MonteCarloNode(Point::None()) {}
+
+	MonteCarloNode::MonteCarloNode(Point move) : _firstChild(NO_CHILDREN), _numChildren(0), _move(move), _totalWins(0), _totalSimulations(0), _virtualLosses(0) {}
+
+	Point MonteCarloNode::Move() const {
+		return _move;
+	}
+
+	bool MonteCarloNode::IsExpanded() const {
+		return _firstChild.load(std::memory_order_acquire) < EXPANDING;
 	}
 
-	bool MonteCarloNode::RunSimulation() {
-		std::default_random_engine randomEngine;
-		randomEngine.seed(static_cast<unsigned int>(std::chrono::high_resolution_clock::now().time_since_epoch().count()));
-		Board b = _board;
-		for (int i = 0; i < 100; ++i) {
-			if (b.IsGameOver()) {
-				break;
-			}
-			auto simValidMoves = b.GetValidMoves(b.GetWhoseTurn());
-			std::uniform_int_distribution<int> simValidMoveDistribution(0, static_cast<int>(simValidMoves.size()) - 1);
-			int simValidMoveIndex = simValidMoveDistribution(randomEngine);
-			b.PlacePiece(simValidMoves[simValidMoveIndex], b.GetWhoseTurn());
-			b.NextTurn();
-		}
+	uint32_t MonteCarloNode::FirstChild() const {
+		return _firstChild.load(std::memory_order_relaxed);
+	}
+
+	int MonteCarloNode::NumChildren() const {
+		return _numChildren;
+	}
+
+	bool MonteCarloNode::TryStartExpanding() {
+		uint32_t expected = NO_CHILDREN;
+		return _firstChild.compare_exchange_strong(expected, EXPANDING, std::memory_order_relaxed);
+	}
 
-		// Since the current board is for the other player's turn, this equation looks swapped.
-		double score = b.Score();
-		bool win = score < 0.0 && _board.GetWhoseTurn() == Color::White || score > 0.0 && _board.GetWhoseTurn() == Color::Black;
-		_lock.lock();
-		if (win) {
-			++_totalWins;
-		}
-		++_totalSimulations;
-		_lock.unlock();
-		return win;
+	void MonteCarloNode::SetChildren(uint32_t firstChild, int numChildren) {
+		// The count has to be in before the first child is, since that's what readers wait on.
+		_numChildren = static_cast<uint16_t>(numChildren);
+		_firstChild.store(firstChild, std::memory_order_release);
 	}
 
-	void MonteCarloNode::SetBoard(const Board& board, const Grid2& lastMove) {
-		_board = board;
-		_lastMove = lastMove;
-		_validMoves = board.GetValidMoves(board.GetWhoseTurn());
+	void MonteCarloNode::AddVirtualLoss() {
+		_virtualLosses.fetch_add(1, std::memory_order_relaxed);
 	}
 
-	Grid2 MonteCarloNode::LastMove() const {
-		return _lastMove;
+	void MonteCarloNode::RemoveVirtualLoss() {
+		_virtualLosses.fetch_sub(1, std::memory_order_relaxed);
 	}
 
-	bool MonteCarloNode::IsValid() const {
-		return _valid;
+	int MonteCarloNode::VirtualLosses() const {
+		return _virtualLosses.load(std::memory_order_relaxed);
 	}
 
-	void MonteCarloNode::SetValid(bool validity) {
-		_valid = validity;
+	void MonteCarloNode::AddResults(int wins, int simulations) {
+		_totalWins.fetch_add(wins, std::memory_order_relaxed);
+		_totalSimulations.fetch_add(simulations, std::memory_order_relaxed);
 	}
 
 	int MonteCarloNode::TotalWins() const {
-		return _totalWins;
+		return _totalWins.load(std::memory_order_relaxed);
 	}
 
 	int MonteCarloNode::TotalSimulations() const {
-		return _totalSimulations;
+		return _totalSimulations.load(std::memory_order_relaxed);
 	}
-}
\ No newline at end of file
+}
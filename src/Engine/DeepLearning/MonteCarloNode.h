@@ -1,48 +1,102 @@
 #pragma once
 
-#include <mutex>
+#include <atomic>
+#include <cstdint>
 
-#include "Board.h"
-#include "Grid2.h"
+#include "Point.h"
 
 namespace BeitaGo {
 	/**
-	 * Defines a child node in the MCTS node.
+	 * Defines a node in the MCTS tree. Nodes live in the tree's NodeArena and refer to their
+	 * children by index, so a node is just the move that led to it, where its children are and
+	 * its results.
+	 *
+	 * A node's wins are counted for the player who made its move, so a parent picks the child
+	 * with the best results for the player to move there.
+	 *
+	 * Search threads share nodes without a lock. The results are atomic counters, and a node's
+	 * children are published all at once by SetChildren, so a thread that sees IsExpanded also
+	 * sees every child.
 	 */
 	class MonteCarloNode {
 		public:
 		/**
-		 * Constructs a node that is disable.
+		 * The first child of a node that hasn't been expanded.
+		 */
+		static constexpr uint32_t NO_CHILDREN = 0xFFFFFFFF;
+
+		/**
+		 * The first child of a node that a thread is expanding, or that couldn't be expanded
+		 * because the arena was full.
+		 */
+		static constexpr uint32_t EXPANDING = 0xFFFFFFFE;
+
+		/**
+		 * Constructs a node with no move, as the root has.
 		 */
 		MonteCarloNode();
 
 		/**
-		 * Runs a random game from this node. Returns whether it was a win or not.
+		 * Constructs a node for the given move.
+		 * @param move
+		 */
+		explicit MonteCarloNode(Point move);
+
+		/**
+		 * Gets the move that created this node.
+		 */
+		Point Move() const;
+
+		/**
+		 * Returns whether this node's children have been added.
+		 */
+		bool IsExpanded() const;
+
+		/**
+		 * Returns the arena index of this node's first child. The rest follow it. Only valid
+		 * once IsExpanded has returned true.
+		 */
+		uint32_t FirstChild() const;
+
+		/**
+		 * Returns how many children this node has. Only valid once IsExpanded has returned true.
+		 */
+		int NumChildren() const;
+
+		/**
+		 * Claims this node for expanding. Returns false if it has already been expanded or
+		 * another thread has claimed it.
+		 */
+		bool TryStartExpanding();
+
+		/**
+		 * Sets where this node's children are in the arena, which must all be made already.
+		 * @param firstChild
+		 * @param numChildren
 		 */
-		bool RunSimulation();
+		void SetChildren(uint32_t firstChild, int numChildren);
 
 		/**
-		 * Sets the current board of this node. For performance purposes, this should be done
-		 * only for valid boards.
+		 * Marks a simulation as going through this node before its results are in.
 		 */
-		void SetBoard(const Board& board, const Grid2& lastMove);
+		void AddVirtualLoss();
 
 		/**
-		 * Gets the move that created this node. If it is PASS, it may most likely be an invalid
-		 * node.
+		 * Unmarks a simulation once its results are in.
 		 */
-		Grid2 LastMove() const;
+		void RemoveVirtualLoss();
 
 		/**
-		 * Returns whether this node was from a valid move or not.
+		 * Returns how many simulations are going through this node right now.
 		 */
-		bool IsValid() const;
+		int VirtualLosses() const;
 
 		/**
-		 * Sets whether this node should be a valid node or not.
-		 * @param validity.
+		 * Adds the results of some simulations that went through this node.
+		 * @param wins
+		 * @param simulations
 		 */
-		void SetValid(bool validity);
+		void AddResults(int wins, int simulations);
 
 		/**
 		 * Returns the number of winning simulations run.
@@ -55,12 +109,11 @@ namespace BeitaGo {
 		int TotalSimulations() const;
 
 		private:
-		bool _valid;
-		Board _board;
-		Grid2 _lastMove;
-		int _totalWins;
-		int _totalSimulations;
-		std::mutex _lock;
-		std::vector<Grid2> _validMoves; // This is just for caching purposes.
+		std::atomic<uint32_t> _firstChild;
+		uint16_t _numChildren;
+		Point _move;
+		std::atomic<int32_t> _totalWins;
+		std::atomic<int32_t> _totalSimulations;
+		std::atomic<int32_t> _virtualLosses;
 	};
-}
\ No newline at end of file
+}
@@ -3,165 +3,300 @@
 #include <algorithm>
 #include <cmath>
 #include <iostream>
+#include <limits>
 #include <random>
 
+#include "PlayoutBatch.h"
+#include "PlayoutBoard.h"
+
 namespace BeitaGo {
+	constexpr size_t MonteCarloTree::DEFAULT_MAX_NODES;
+	constexpr uint32_t MonteCarloTree::ROOT;
 
-	MonteCarloTree::MonteCarloTree(const Board& board) : _board(board), _validMoves(board.GetValidMoves(board.GetWhoseTurn())), _children(board.GetDimensions().X() * board.GetDimensions().Y() + 1), _totalWins(0), _totalSimulations(0) {
-		// When initialised, all children will be marked as invalid. Go through all the valid moves,
-		// and mark those as valid.
-		for (const Grid2& g : _validMoves) {
-			int index = Grid2ToIndex(g);
-			Board b = _board;
-			b.PlacePiece(g, b.GetWhoseTurn());
-			b.NextTurn();
-			_children[index].SetBoard(b, g);
-			_children[index].SetValid(true);
-		}
+	MonteCarloTree::MonteCarloTree(const Board& board, ThreadPool& pool, size_t maxNodes) : _board(board), _pool(pool), _nodes(maxNodes), _nextStream(0) {
+		// From here this is always MonteCarloTree's Reset, so a subclass does the rest of its own
+		// setup in its constructor.
+		Reset(board);
 	}
 
-	void MonteCarloTree::RunSimulation() {
-		//TODO: Use the heuristic here.
-		constexpr double c = 1.500;
-		std::default_random_engine randomEngine;
-		randomEngine.seed(static_cast<unsigned int>(std::chrono::high_resolution_clock::now().time_since_epoch().count()));
-
-		_lock.lock();
-		std::vector<std::pair<double, Grid2>> movesOrdered;
-		for (const Grid2& g : _validMoves) {
-			const MonteCarloNode& node = _children[Grid2ToIndex(g)];
-			movesOrdered.emplace_back(std::make_pair(static_cast<double>(node.TotalWins()) / node.TotalSimulations() + c * std::sqrt(std::log(_totalSimulations) / node.TotalSimulations()), g));
-		}
-		std::sort(movesOrdered.begin(), movesOrdered.end(), [](const std::pair<double, Grid2>& a, const std::pair<double, Grid2>& b) -> bool { return a.first > b.first; });
+	void MonteCarloTree::Reset(const Board& board) {
+		_board = board;
+		Grid2 dimensions = board.GetDimensions();
+		_virtualLoss = dimensions.X() == PlayoutBatch::SIZE && dimensions.Y() == PlayoutBatch::SIZE ? PlayoutBatch::LANES : 1;
+		_totalWins = 0;
+		_totalSimulations = 0;
+		std::random_device device;
+		SetSeed(static_cast<uint64_t>(device()) << 32 | device());
+		_nodes.Reset();
+		_nodes.Allocate(1);
+		_nodes.Construct(ROOT);
 
-		// Since there may be multiple moves with the same best score, let's just randomly pick one
-		// that's the best.
-		std::vector<std::pair<double, Grid2>> bestMoves;
-		for (const auto& p : movesOrdered) {
-			if (p.first < movesOrdered[0].first) {
-				break;
-			} else {
-				bestMoves.push_back(p);
+		// The root always has its children, so every valid move can be looked up straight away.
+		// They're the legal points in row order and then a pass, just as GetValidMoves lists them.
+		_rootChildren.assign(dimensions.X() * dimensions.Y() + 1, NodeArena<MonteCarloNode>::NONE);
+		_validMoves.clear();
+		if (_nodes[ROOT].TryStartExpanding() && Expand(ROOT, board.LegalMask(board.GetWhoseTurn()))) {
+			const MonteCarloNode& root = _nodes[ROOT];
+			for (int i = 0; i < root.NumChildren(); ++i) {
+				uint32_t child = root.FirstChild() + i;
+				_rootChildren[_nodes[child].Move().MoveIndex(PassIndex())] = child;
+				_validMoves.push_back(_nodes[child].Move().ToGrid2(dimensions.X()));
 			}
 		}
-		_lock.unlock();
-
-		std::uniform_int_distribution<int> validMoveDistribution(0, static_cast<int>(bestMoves.size()) - 1);
-		int validMoveIndex = validMoveDistribution(randomEngine);
-		MonteCarloNode& node = _children[Grid2ToIndex(bestMoves[validMoveIndex].second)];
-		if (node.RunSimulation()) {
-			_lock.lock();
-			++_totalWins;
-			_lock.unlock();
-		}
-		_lock.lock();
-		++_totalSimulations;
-		//std::cout << _totalWins << " / " << _totalSimulations << "(" << _totalWins / static_cast<double>(_totalSimulations) * 100.0 << "%)\n";
-		_lock.unlock();
-	}
-
-	void MonteCarloTree::InitializeNodes(int n, int maxThreads) {
-		// There's n * ((x * y) + 1) simulations.
-		const int x = _board.GetDimensions().X();
-		const int y = _board.GetDimensions().Y();
-		
-		std::vector<std::thread> threads;
-		for (int i = 0; i < maxThreads; ++i) {
-			std::vector<int> indiciesToCheck;
-			for (int a = i; a < (n * (x * y + 1)); a += maxThreads) {
-				indiciesToCheck.push_back(a % (x * y + 1));
-			}
+	}
 
-			//TODO: This will cut off some desired executions.
-			threads.emplace_back(std::thread([&, indiciesToCheck]() {
-				for (const int& a : indiciesToCheck) {
-					MonteCarloNode& node = _children[a];
-					if (node.IsValid()) {
-						if (node.RunSimulation()) {
-							_lock.lock();
-							++_totalWins;
-							_lock.unlock();
-						}
-						_lock.lock();
-						++_totalSimulations;
-						//std::cout << _totalWins << " / " << _totalSimulations << "(" << _totalWins / static_cast<double>(_totalSimulations) * 100.0 << "%)\n";
-						_lock.unlock();
-					}
-				}
-			}));
-		}
-		for (int i = 0; i < maxThreads; ++i) {
-			threads[i].join();
-		}
+	void MonteCarloTree::SetSeed(uint64_t seed) {
+		_seed = seed;
+		_nextStream = 0;
+	}
+
+	void MonteCarloTree::RunSimulation() {
+		Worker worker(_board, RandomStream(_seed, _nextStream++));
+		Simulate(NodeArena<MonteCarloNode>::NONE, worker);
 	}
 
-	void MonteCarloTree::RunSimulations(int n, int maxThreads) {
-		if (maxThreads == 1) {
-			for (int x = 0; x < n; ++x) {
-				RunSimulation();
+	void MonteCarloTree::InitializeNodes(int n) {
+		// There's n simulations for every valid move.
+		std::vector<uint32_t> children;
+		for (int i = 0; i < n; ++i) {
+			for (uint32_t child : _rootChildren) {
+				if (child != NodeArena<MonteCarloNode>::NONE) {
+					children.push_back(child);
+				}
 			}
-		} else {
-			std::vector<std::thread> threads;
-			for (int i = 0; i < maxThreads; ++i) {
-				//TODO: This will cut off some desired executions.
-				threads.emplace_back(std::thread([&]() { this->RunSimulations(n / maxThreads, 1); }));
+		}
+
+		std::atomic<size_t> next(0);
+		_pool.ParallelFor(_pool.Size(), [&](int) {
+			Worker worker(_board, RandomStream(_seed, _nextStream++));
+			for (size_t a = next++; a < children.size(); a = next++) {
+				Simulate(children[a], worker);
 			}
-			for (int i = 0; i < maxThreads; ++i) {
-				threads[i].join();
+		});
+	}
+
+	void MonteCarloTree::RunSimulations(int n) {
+		// Each worker takes simulations off the count until there are none left, so exactly n
+		// run however the workers keep up with each other.
+		std::atomic<int> remaining(n);
+		_pool.ParallelFor(_pool.Size(), [&](int) {
+			Worker worker(_board, RandomStream(_seed, _nextStream++));
+			while (remaining.fetch_sub(1, std::memory_order_relaxed) > 0) {
+				Simulate(NodeArena<MonteCarloNode>::NONE, worker);
 			}
-		}
+		});
 	}
 
-	void MonteCarloTree::RunSimulations(const std::chrono::high_resolution_clock::time_point& endTime, int maxThreads) {
-		if (maxThreads == 1) {
+	void MonteCarloTree::RunSimulations(const std::chrono::high_resolution_clock::time_point& endTime) {
+		_pool.ParallelFor(_pool.Size(), [&](int) {
+			Worker worker(_board, RandomStream(_seed, _nextStream++));
 			while (std::chrono::high_resolution_clock::now() < endTime) {
-				RunSimulation();
+				Simulate(NodeArena<MonteCarloNode>::NONE, worker);
 			}
-		} else {
-			std::vector<std::thread> threads;
-			for (int i = 0; i < maxThreads; ++i) {
-				//TODO: This will cut off some desired executions.
-				threads.emplace_back(std::thread([&]() { this->RunSimulations(endTime, 1); }));
+		});
+	}
+
+	Grid2 MonteCarloTree::GetMostLikelyMove() const {
+		const MonteCarloNode& root = _nodes[ROOT];
+		const MonteCarloNode* best = nullptr;
+		for (int i = 0; i < root.NumChildren(); ++i) {
+			const MonteCarloNode& node = _nodes[root.FirstChild() + i];
+			if (node.TotalSimulations() == 0) {
+				continue;
 			}
-			for (int i = 0; i < maxThreads; ++i) {
-				threads[i].join();
+			// Ties between equally simulated moves go to the better win rate.
+			if (best == nullptr || node.TotalSimulations() > best->TotalSimulations() || (node.TotalSimulations() == best->TotalSimulations() && static_cast<double>(node.TotalWins()) / node.TotalSimulations() > static_cast<double>(best->TotalWins()) / best->TotalSimulations())) {
+				best = &node;
 			}
 		}
+		return best == nullptr ? PASS : best->Move().ToGrid2(_board.GetDimensions().X());
 	}
 
-	Grid2 MonteCarloTree::GetMostLikelyMove() const {
-		auto bestMove = std::make_pair(0.0, PASS);
-		for (const MonteCarloNode& node : _children) {
-			if (node.IsValid() && node.TotalSimulations() > 0) {
-				//TODO: Make this heuristic better.
-				double score = node.TotalWins() / static_cast<double>(node.TotalSimulations());
-				//std::cout << "(" << node.LastMove().X() << ", " << node.LastMove().Y() << ") = " << score << "\n";
-				if (score > bestMove.first) {
-					bestMove.first = score;
-					bestMove.second = node.LastMove();
+	size_t MonteCarloTree::GetNodeCount() const {
+		return _nodes.Size();
+	}
+
+	int MonteCarloTree::GetTotalSimulations() const {
+		return _totalSimulations;
+	}
+
+	int MonteCarloTree::GetPrincipalDepth() const {
+		int depth = 0;
+		uint32_t node = ROOT;
+		while (_nodes[node].IsExpanded() && _nodes[node].NumChildren() > 0) {
+			const MonteCarloNode& parent = _nodes[node];
+			uint32_t best = parent.FirstChild();
+			for (int i = 1; i < parent.NumChildren(); ++i) {
+				if (_nodes[parent.FirstChild() + i].TotalSimulations() > _nodes[best].TotalSimulations()) {
+					best = parent.FirstChild() + i;
 				}
 			}
+			if (_nodes[best].TotalSimulations() == 0) {
+				break;
+			}
+			node = best;
+			++depth;
+		}
+		return depth;
+	}
+
+	double MonteCarloTree::SelectionValue(const MonteCarloNode& parent, const MonteCarloNode& child, bool /*atRoot*/) const {
+		// A virtual loss adds simulations without wins, as many as the simulation will play.
+		int simulations = child.TotalSimulations() + child.VirtualLosses() * _virtualLoss;
+		if (simulations == 0) {
+			return std::numeric_limits<double>::infinity();
 		}
-		return bestMove.second;
+		int parentSimulations = std::max(parent.TotalSimulations() + parent.VirtualLosses() * _virtualLoss, 1);
+		return static_cast<double>(child.TotalWins()) / simulations + EXPLORATION * std::sqrt(std::log(parentSimulations) / simulations);
+	}
+
+	const MonteCarloNode* MonteCarloTree::RootChild(const Grid2& g) const {
+		uint32_t child = _rootChildren[Grid2ToIndex(g)];
+		return child == NodeArena<MonteCarloNode>::NONE ? nullptr : &_nodes[child];
 	}
 
 	int MonteCarloTree::PassIndex() const {
-		return static_cast<int>(_children.size() - 1);
+		return static_cast<int>(_rootChildren.size() - 1);
 	}
 
 	int MonteCarloTree::Grid2ToIndex(const Grid2& g) const {
-		if (g == PASS) {
-			return PassIndex();
-		} else {
-			return g.Y() * _board.GetDimensions().X() + g.X();
-		}
+		return Point::FromGrid2(g, _board.GetDimensions().X()).MoveIndex(PassIndex());
 	}
 
 	Grid2 MonteCarloTree::IndexToGrid2(int index) const {
-		if (index == PassIndex()) {
-			return PASS;
+		return Point::FromMoveIndex(index, PassIndex()).ToGrid2(_board.GetDimensions().X());
+	}
+
+	void MonteCarloTree::Simulate(uint32_t rootChild, Worker& worker) {
+		const int width = _board.GetDimensions().X();
+		Board& board = worker.board;
+		std::vector<uint32_t>& path = worker.path;
+		std::vector<Point>& moves = worker.moves;
+		RandomStream& random = worker.random;
+
+		// Walk down to a leaf, putting a virtual loss on every node on the way so the threads
+		// behind this one go elsewhere until its results are in.
+		path.assign(1, ROOT);
+		moves.clear();
+		_nodes[ROOT].AddVirtualLoss();
+		if (rootChild != NodeArena<MonteCarloNode>::NONE) {
+			_nodes[rootChild].AddVirtualLoss();
+			path.push_back(rootChild);
+			moves.push_back(_nodes[rootChild].Move());
 		} else {
-			return Grid2(index % _board.GetDimensions().X(), index / _board.GetDimensions().X());
+			uint32_t node = ROOT;
+			while (_nodes[node].IsExpanded() && _nodes[node].NumChildren() > 0) {
+				node = SelectChild(node, node == ROOT, random);
+				_nodes[node].AddVirtualLoss();
+				path.push_back(node);
+				moves.push_back(_nodes[node].Move());
+			}
+		}
+		uint32_t leaf = path.back();
+		bool expand = rootChild == NodeArena<MonteCarloNode>::NONE && !_nodes[leaf].IsExpanded() && _nodes[leaf].TotalSimulations() >= EXPAND_THRESHOLD;
+
+		for (Point move : moves) {
+			board.PlacePiece(move.ToGrid2(width), board.GetWhoseTurn());
+			board.NextTurn();
+		}
+
+		// A leaf that has been simulated enough gets its children, and this iteration goes on
+		// to one of them. If another thread is already adding them, this one just plays out the
+		// leaf. A leaf that doesn't fit in the arena stays claimed, so it's never tried again.
+		if (expand && !board.IsGameOver() && _nodes[leaf].TryStartExpanding() && Expand(leaf, board.LegalMask(board.GetWhoseTurn()))) {
+			const MonteCarloNode& node = _nodes[leaf];
+			uint32_t child = node.FirstChild() + RandomBelow(random, node.NumChildren());
+			_nodes[child].AddVirtualLoss();
+			path.push_back(child);
+			moves.push_back(_nodes[child].Move());
+			board.PlacePiece(moves.back().ToGrid2(width), board.GetWhoseTurn());
+			board.NextTurn();
+		}
+
+		std::pair<int, int> result = Playout(worker);
+		int blackWins = result.first;
+		int games = result.second;
+
+		// Each node counts wins for whoever made its move, which alternates down the path. The
+		// root's move was the other player's.
+		Color rootPlayer = _board.GetWhoseTurn();
+		int rootPlayerWins = rootPlayer == Color::Black ? blackWins : games - blackWins;
+		for (size_t i = 0; i < path.size(); ++i) {
+			bool rootPlayerMoved = i % 2 == 1;
+			_nodes[path[i]].AddResults(rootPlayerMoved ? rootPlayerWins : games - rootPlayerWins, games);
+			_nodes[path[i]].RemoveVirtualLoss();
+		}
+		_totalWins += rootPlayerWins;
+		_totalSimulations += games;
+		//std::cout << _totalWins << " / " << _totalSimulations << "(" << _totalWins / static_cast<double>(_totalSimulations) * 100.0 << "%)\n";
+
+		// Take the moves back, which only touches what they changed, so the board is ready for
+		// the next iteration.
+		for (size_t i = 0; i < moves.size(); ++i) {
+			board.UndoMove();
+		}
+	}
+
+	bool MonteCarloTree::Expand(uint32_t node, const Bitboard& legal) {
+		int numChildren = legal.Count() + 1;
+		uint32_t first = _nodes.Allocate(numChildren);
+		if (first == NodeArena<MonteCarloNode>::NONE) {
+			return false;
+		}
+		uint32_t child = first;
+		legal.ForEach([&](int index) {
+			_nodes.Construct(child++, Point(index));
+		});
+		_nodes.Construct(child, Point::Pass());
+		_nodes[node].SetChildren(first, numChildren);
+		return true;
+	}
+
+	uint32_t MonteCarloTree::SelectChild(uint32_t node, bool atRoot, RandomStream& random) const {
+		// Start looking from a random child, so ties, like between children that haven't been
+		// simulated yet, don't always go the same way.
+		const MonteCarloNode& parent = _nodes[node];
+		int numChildren = parent.NumChildren();
+		int start = RandomBelow(random, numChildren);
+		uint32_t best = parent.FirstChild() + start;
+		double bestValue = SelectionValue(parent, _nodes[best], atRoot);
+		for (int i = 1; i < numChildren; ++i) {
+			uint32_t child = parent.FirstChild() + (start + i) % numChildren;
+			double value = SelectionValue(parent, _nodes[child], atRoot);
+			if (value > bestValue) {
+				best = child;
+				bestValue = value;
+			}
+		}
+		return best;
+	}
+
+	std::pair<int, int> MonteCarloTree::Playout(Worker& worker) {
+		// The score is how far ahead white is.
+		const Board& board = worker.board;
+		RandomStream& random = worker.random;
+		Grid2 dimensions = board.GetDimensions();
+		if (dimensions.X() == PlayoutBatch::SIZE && dimensions.Y() == PlayoutBatch::SIZE) {
+			PlayoutBatch batch(board);
+			batch.Run(random);
+			int blackWins = 0;
+			for (int l = 0; l < PlayoutBatch::LANES; ++l) {
+				if (batch.Score(l) < 0.0) {
+					++blackWins;
+				}
+			}
+			return std::make_pair(blackWins, PlayoutBatch::LANES);
+		}
+
+		// Playouts stop at the first pass once the board has settled, rather than playing out the
+		// dead stones. The cap only stops a long ko fight, since playouts just check simple ko.
+		// Copying the root's playout board and playing the tree's few moves on it is much cheaper
+		// than reading the whole board back out of the worker's.
+		PlayoutBoard b(worker.root);
+		for (Point move : worker.moves) {
+			b.Play(move.IsPass() ? PlayoutBoard::PASS_INDEX : b.ToIndex(move.ToGrid2(dimensions.X())));
 		}
+		double score = b.PlayOut(random, 3 * dimensions.X() * dimensions.Y());
+		return std::make_pair(score < 0.0 ? 1 : 0, 1);
 	}
-}
\ No newline at end of file
+}
@@ -1,26 +1,83 @@
 #pragma once
 
+#include <atomic>
 #include <chrono>
-#include <mutex>
-#include <thread>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
 #include <vector>
 
 #include "Board.h"
 #include "Grid2.h"
 #include "MonteCarloAIPlayer.h"
 #include "MonteCarloNode.h"
+#include "NodeArena.h"
+#include "PlayoutBoard.h"
+#include "Point.h"
+#include "RandomStream.h"
+#include "ThreadPool.h"
 
 namespace BeitaGo {
 
 	/**
 	 * Defines the head of the tree that computes a MCTS for the board.
+	 *
+	 * Each iteration walks down from the root picking the child with the best SelectionValue,
+	 * adds the children of the leaf it reaches once that leaf has had EXPAND_THRESHOLD
+	 * simulations, plays random games from there and adds their results to every node on the
+	 * way back up. The nodes all live in one NodeArena, so Reset throws a search away and keeps
+	 * the memory for the next one.
+	 *
+	 * Threads search the same tree without taking any locks. Every node a thread walks through
+	 * counts a virtual loss until its results come back, so the other threads see that line as
+	 * worse than it is and spread out over the tree instead of all playing out the same leaf.
+	 * Each thread also draws its own RandomStream of the search's seed, so no two play the same
+	 * games.
 	 */
 	class MonteCarloTree {
 		// Purely for debugging properties.
 		friend class MonteCarloAIPlayer;
 
 		public:
-		MonteCarloTree(const Board& board);
+		/**
+		 * How many nodes a tree holds by default. Once the arena is full, leaves stop being
+		 * expanded but still get simulated.
+		 */
+		static constexpr size_t DEFAULT_MAX_NODES = 1 << 21;
+
+		/**
+		 * How many simulations a leaf needs before its children are added.
+		 */
+		static constexpr int EXPAND_THRESHOLD = 16;
+
+		/**
+		 * How much the search favours children it knows little about.
+		 */
+		static constexpr double EXPLORATION = 1.500;
+
+		/**
+		 * Constructs a tree for the given board, which searches on the given pool's workers.
+		 * @param board
+		 * @param pool
+		 * @param maxNodes
+		 */
+		MonteCarloTree(const Board& board, ThreadPool& pool, size_t maxNodes = DEFAULT_MAX_NODES);
+
+		virtual ~MonteCarloTree() = default;
+
+		/**
+		 * Throws away the search and starts a new one from the given board, keeping the nodes'
+		 * memory.
+		 * @param board
+		 */
+		virtual void Reset(const Board& board);
+
+		/**
+		 * Sets the seed that the search's random streams come from. Reset picks a new one, so
+		 * this is for running a search again exactly as before, when it only uses one thread.
+		 * @param seed
+		 */
+		void SetSeed(uint64_t seed);
 
 		/**
 		 * Runs an iteration of the Monte Carlo Tree Search.
@@ -29,40 +86,155 @@ namespace BeitaGo {
 
 		/**
 		 * To set up the nodes, we run a fixed number of initial simulations on each one.
-		 * @param maxThreads
+		 * @param n
 		 */
-		virtual void InitializeNodes(int n, int maxThreads = std::thread::hardware_concurrency());
+		virtual void InitializeNodes(int n);
 
 		/**
-		 * Runs n iterations of the Monte Carlo Tree Search spread among a given number of threads.
+		 * Runs exactly n iterations of the Monte Carlo Tree Search spread among the pool's
+		 * workers.
 		 * @param n
-		 * @param maxThreads
 		 */
-		virtual void RunSimulations(int n, int maxThreads = std::thread::hardware_concurrency());
+		virtual void RunSimulations(int n);
 
 		/**
 		 * Runs as many iterations of the Monte Carlo Tree Search until the time is reached.
-		 * @param n
-		 * @param maxThreads
+		 * @param endTime
 		 */
-		virtual void RunSimulations(const std::chrono::high_resolution_clock::time_point& endTime, int maxThreads = std::thread::hardware_concurrency());
+		virtual void RunSimulations(const std::chrono::high_resolution_clock::time_point& endTime);
 
 		/**
-		 * Returns the move that was computed to have the best likelihood of victory.
+		 * Returns the move that was computed to have the best likelihood of victory. This is the
+		 * root's most simulated child, which the search only keeps going back to if it keeps
+		 * winning.
 		 * @return
 		 */
 		virtual Grid2 GetMostLikelyMove() const;
 
+		/**
+		 * Returns how many nodes the tree has.
+		 * @return
+		 */
+		size_t GetNodeCount() const;
+
+		/**
+		 * Returns how many moves deep the tree goes along its most simulated line.
+		 * @return
+		 */
+		int GetPrincipalDepth() const;
+
+		/**
+		 * Returns the total number of simulations this tree has run.
+		 * @return
+		 */
+		int GetTotalSimulations() const;
+
 		protected:
+		/**
+		 * The arena index of the root.
+		 */
+		static constexpr uint32_t ROOT = 0;
+
 		Board _board;
-		std::vector<MonteCarloNode> _children;
-		int _totalWins;
-		int _totalSimulations;
-		std::mutex _lock;
-		const std::vector<Grid2> _validMoves; // This is just for caching purposes.
+		ThreadPool& _pool;
+		NodeArena<MonteCarloNode> _nodes;
+		std::vector<uint32_t> _rootChildren; // The arena index of the root's child for each move index, or NodeArena::NONE.
+		int _virtualLoss; // How many lost games a simulation still going through a node counts as.
+		std::atomic<int> _totalWins;
+		std::atomic<int> _totalSimulations;
+		uint64_t _seed;
+		std::atomic<uint64_t> _nextStream; // The stream of _seed the next thread to start gets.
+		std::vector<Grid2> _validMoves; // The moves of the root's children, in order.
 
+		/**
+		 * Returns how good a child looks to the player choosing between its parent's children:
+		 * its win rate plus a bonus for having been simulated less than its siblings, with the
+		 * virtual losses of simulations still going through either counted in. Children that
+		 * haven't been simulated come first.
+		 * @param parent
+		 * @param child
+		 * @param atRoot Whether the parent is the root.
+		 * @return
+		 */
+		virtual double SelectionValue(const MonteCarloNode& parent, const MonteCarloNode& child, bool atRoot) const;
+
+		/**
+		 * Returns the root's child for a move, or nullptr if the move isn't valid.
+		 * @param g
+		 * @return
+		 */
+		const MonteCarloNode* RootChild(const Grid2& g) const;
+
+		/**
+		 * Returns the index of the pass child, which comes after one child per point.
+		 * @return
+		 */
 		int PassIndex() const;
+
+		/**
+		 * Returns the index of a move's child. Children are laid out as Point::MoveIndex
+		 * describes, the same as the outputs of DeepLearningAIPlayer's network.
+		 * @param g
+		 * @return
+		 */
 		int Grid2ToIndex(const Grid2& g) const;
+
+		/**
+		 * Returns the move of a child's index.
+		 * @param index
+		 * @return
+		 */
 		Grid2 IndexToGrid2(int index) const;
+
+		private:
+		/**
+		 * What one thread needs to run iterations: its own copy of the board, which it plays the
+		 * tree's moves on and then takes them back, a playout board of the root, which playouts
+		 * copy and play the tree's moves on, the path it took, and its random stream. It's made
+		 * once for all of a thread's iterations, so they don't copy the board or allocate.
+		 */
+		struct Worker {
+			Board board;
+			PlayoutBoard root;
+			std::vector<uint32_t> path;
+			std::vector<Point> moves;
+			RandomStream random;
+
+			Worker(const Board& board, RandomStream random) : board(board), root(board), random(random) {}
+		};
+
+		/**
+		 * Runs one iteration. If rootChild is a child of the root, the iteration simulates from
+		 * it rather than walking down the tree. The worker's board is left as it was.
+		 * @param rootChild
+		 * @param worker
+		 */
+		void Simulate(uint32_t rootChild, Worker& worker);
+
+		/**
+		 * Gives a node one child for each point set in legal, and one for passing. Returns false
+		 * if the arena is full. The node must have been claimed with TryStartExpanding.
+		 * @param node
+		 * @param legal
+		 * @return
+		 */
+		bool Expand(uint32_t node, const Bitboard& legal);
+
+		/**
+		 * Returns the child of a node with the best SelectionValue.
+		 * @param node
+		 * @param atRoot
+		 * @param random
+		 * @return
+		 */
+		uint32_t SelectChild(uint32_t node, bool atRoot, RandomStream& random) const;
+
+		/**
+		 * Plays random games to the end from the worker's board, a PlayoutBatch of them on a 9x9
+		 * board and one on any other. Returns how many black won and how many were played.
+		 * @param worker
+		 * @return
+		 */
+		static std::pair<int, int> Playout(Worker& worker);
 	};
-}
\ No newline at end of file
+}
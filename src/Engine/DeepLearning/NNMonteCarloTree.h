@@ -10,34 +10,35 @@
 namespace BeitaGo {
 	class NNMonteCarloTree : public MonteCarloTree {
 		public:
-		NNMonteCarloTree(const Board& board, DeepLearningAIPlayer::NetworkType network);
+		NNMonteCarloTree(const Board& board, ThreadPool& pool, DeepLearningAIPlayer::NetworkType network);
 
 		~NNMonteCarloTree();
 
 		/**
-		 * Runs an iteration of the Monte Carlo Tree Search.
+		 * Throws away the search and starts a new one from the given board, asking the network
+		 * about it again.
+		 * @param board
 		 */
-		virtual void RunSimulation() override;
+		virtual void Reset(const Board& board) override;
 
 		/**
 		 * To set up the nodes, we run a fixed number of initial simulations on each one.
-		 * @param maxThreads
+		 * @param n
 		 */
-		virtual void InitializeNodes(int n, int maxThreads = std::thread::hardware_concurrency()) override;
+		virtual void InitializeNodes(int n) override;
 
 		/**
-		 * Runs n iterations of the Monte Carlo Tree Search spread among a given number of threads.
+		 * Runs exactly n iterations of the Monte Carlo Tree Search spread among the pool's
+		 * workers.
 		 * @param n
-		 * @param maxThreads
 		 */
-		virtual void RunSimulations(int n, int maxThreads = std::thread::hardware_concurrency()) override;
+		virtual void RunSimulations(int n) override;
 
 		/**
 		 * Runs as many iterations of the Monte Carlo Tree Search until the time is reached.
-		 * @param n
-		 * @param maxThreads
+		 * @param endTime
 		 */
-		virtual void RunSimulations(const std::chrono::high_resolution_clock::time_point& endTime, int maxThreads = std::thread::hardware_concurrency()) override;
+		virtual void RunSimulations(const std::chrono::high_resolution_clock::time_point& endTime) override;
 
 		/**
 		 * Returns the move that was computed to have the best likelihood of victory.
@@ -46,9 +47,9 @@ namespace BeitaGo {
 		virtual Grid2 GetMostLikelyMove() const override;
 
 		/**
-		 * Returns the value returned by the heuristic for the given move.
+		 * Returns the value returned by the heuristic for the given move, or 0 if it isn't valid.
 		 */
-		double GetHeuristicValue(const Grid2& g, bool checkIfValid = true);
+		double GetHeuristicValue(const Grid2& g);
 
 		/**
 		 * Returns the value returned by the heuristic for every move.
@@ -61,12 +62,24 @@ namespace BeitaGo {
 		 */
 		std::array<double, DeepLearningAIPlayer::OUTPUT_VECTOR_SIZE> GetAllHeuristicValuesNormalised();
 
+		protected:
 		/**
-		 * Returns the total number of simulations this tree has run.
+		 * Adds a large bonus to the root's child for the network's pick, so the search looks at
+		 * it most unless its simulations say otherwise. Deeper in the tree the network isn't
+		 * asked, so children are picked as MonteCarloTree does.
+		 * @param parent
+		 * @param child
+		 * @param atRoot
+		 * @return
 		 */
-		int GetTotalSimulations() const;
+		virtual double SelectionValue(const MonteCarloNode& parent, const MonteCarloNode& child, bool atRoot) const override;
 
 		private:
+		/**
+		 * Asks the network for its pick on the tree's board.
+		 */
+		void EvaluateNetwork();
+
 		DeepLearningAIPlayer::NetworkType _network;
 		std::array<double, DeepLearningAIPlayer::OUTPUT_VECTOR_SIZE> _networkValues;
 	};
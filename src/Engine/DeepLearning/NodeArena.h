@@ -0,0 +1,106 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace BeitaGo {
+	/**
+	 * A block of nodes for a search tree. Nodes are handed out in contiguous runs and named by
+	 * their 32-bit index, so a node's children can be stored as the index of the first one and a
+	 * count, and the whole tree is thrown away at once by Reset. The memory is set aside up front
+	 * and never moves, so the arena is full once it reaches its capacity rather than growing.
+	 *
+	 * Any number of threads can call Allocate at once, and nodes already handed out can be used
+	 * while they do.
+	 */
+	template <typename Node>
+	class NodeArena {
+		static_assert(std::is_trivially_destructible<Node>::value, "Reset doesn't destroy nodes.");
+
+		public:
+		/**
+		 * The index Allocate returns when there isn't room.
+		 */
+		static constexpr uint32_t NONE = 0xFFFFFFFF;
+
+		/**
+		 * Constructs an empty arena that can hold up to capacity nodes.
+		 * @param capacity
+		 */
+		explicit NodeArena(size_t capacity) : _capacity(capacity), _size(0), _nodes(new Storage[capacity]) {}
+
+		/**
+		 * Sets aside count nodes next to each other and returns the index of the first, or NONE
+		 * if they don't fit. Each of them has to be made with Construct before it's used.
+		 * @param count
+		 * @return
+		 */
+		uint32_t Allocate(size_t count) {
+			size_t first = _size.load(std::memory_order_relaxed);
+			do {
+				if (first + count > _capacity) {
+					return NONE;
+				}
+			} while (!_size.compare_exchange_weak(first, first + count, std::memory_order_relaxed));
+			return static_cast<uint32_t>(first);
+		}
+
+		/**
+		 * Makes the node at an index that Allocate has handed out.
+		 * @param index
+		 * @param args The arguments for the node's constructor.
+		 */
+		template <typename... Args>
+		void Construct(uint32_t index, Args&&... args) {
+			new (&_nodes[index]) Node(std::forward<Args>(args)...);
+		}
+
+		/**
+		 * Removes every node, keeping the memory for the next search. Nothing else may be using
+		 * the arena.
+		 */
+		void Reset() {
+			_size.store(0, std::memory_order_relaxed);
+		}
+
+		/**
+		 * Returns how many nodes are in use.
+		 * @return
+		 */
+		size_t Size() const {
+			return _size.load(std::memory_order_relaxed);
+		}
+
+		/**
+		 * Returns how many nodes the arena can hold.
+		 * @return
+		 */
+		size_t Capacity() const {
+			return _capacity;
+		}
+
+		Node& operator[](uint32_t index) {
+			return *reinterpret_cast<Node*>(&_nodes[index]);
+		}
+
+		const Node& operator[](uint32_t index) const {
+			return *reinterpret_cast<const Node*>(&_nodes[index]);
+		}
+
+		private:
+		// Raw memory, so the pages aren't touched until nodes are put in them.
+		using Storage = typename std::aligned_storage<sizeof(Node), alignof(Node)>::type;
+
+		size_t _capacity;
+		std::atomic<size_t> _size;
+		std::unique_ptr<Storage[]> _nodes;
+	};
+
+	template <typename Node>
+	constexpr uint32_t NodeArena<Node>::NONE;
+}
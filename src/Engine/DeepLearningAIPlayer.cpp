@@ -1,5 +1,6 @@
 #include "DeepLearningAIPlayer.h"
 
+#include <algorithm>
 #include <fstream>
 
 #include "Engine.h"
@@ -25,7 +26,12 @@ namespace BeitaGo {
 	}
 
 	Grid2 DeepLearningAIPlayer::MakeDecision() const {
-		NNMonteCarloTree tree(GetEngine().GetBoard(), _network);
+		if (_networkTree) {
+			_networkTree->Reset(GetEngine().GetBoard());
+		} else {
+			_networkTree.reset(new NNMonteCarloTree(GetEngine().GetBoard(), GetEngine().GetThreadPool(), _network));
+		}
+		NNMonteCarloTree& tree = *_networkTree;
 		std::chrono::high_resolution_clock::time_point endTime = std::chrono::high_resolution_clock::now() + std::chrono::duration_cast<std::chrono::seconds>(_thinkingTime);
 		//tree.InitializeNodes(1);
 		tree.RunSimulations(endTime);
@@ -39,25 +45,24 @@ namespace BeitaGo {
 	}
 	
 	std::array<bool, DeepLearningAIPlayer::INPUT_VECTOR_SIZE> DeepLearningAIPlayer::BoardToInputVector(const Board& board) {
+		// Each layer is a plane of points in the same order as the network's outputs.
+		constexpr int points = EXPECTED_BOARD_SIZE * EXPECTED_BOARD_SIZE;
 		std::array<bool, INPUT_VECTOR_SIZE> inputVector;
-		int index = 0;
 		for (int i = 0; i < 2 * HISTORY_USED; ++i) {
 			std::vector<std::vector<Color>> historyBoard = board.GetPreviousLayout(i / 2);
-			for (int y = 0; y < board.GetDimensions().Y(); ++y) {
-				for (int x = 0; x < board.GetDimensions().X(); ++x) {
-					if (i % 2 == 0) {
-							inputVector[index] = historyBoard[x][y] == Color::Black;
-					} else {
-							inputVector[index] = historyBoard[x][y] == Color::White;
-					}
-					++index;
+			Color color = i % 2 == 0 ? Color::Black : Color::White;
+			for (int y = 0; y < EXPECTED_BOARD_SIZE; ++y) {
+				for (int x = 0; x < EXPECTED_BOARD_SIZE; ++x) {
+					inputVector[i * points + Point::At(x, y, EXPECTED_BOARD_SIZE).Index()] = historyBoard[x][y] == color;
 				}
 			}
 		}
-		for (int y = 0; y < board.GetDimensions().Y(); ++y) {
-			for (int x = 0; x < board.GetDimensions().X(); ++x) {
-				inputVector[index] = board.GetWhoseTurn() == Color::Black;
-				++index;
+		std::fill(inputVector.begin() + 2 * HISTORY_USED * points, inputVector.begin() + (2 * HISTORY_USED + 1) * points, board.GetWhoseTurn() == Color::Black);
+		for (int i = 0; i < FEATURE_PLANE_COUNT; ++i) {
+			Bitboard plane = board.GetFeaturePlane(static_cast<FeaturePlane>(i));
+			int offset = (2 * HISTORY_USED + 1 + i) * points;
+			for (int p = 0; p < points; ++p) {
+				inputVector[offset + p] = plane.Test(p);
 			}
 		}
 		return inputVector;
@@ -76,6 +81,14 @@ namespace BeitaGo {
 		return m;
 	}
 
+	unsigned long DeepLearningAIPlayer::MoveToOutput(const Grid2& move) {
+		return static_cast<unsigned long>(Point::FromGrid2(move, EXPECTED_BOARD_SIZE).MoveIndex(OUTPUT_VECTOR_SIZE - 1));
+	}
+
+	Grid2 DeepLearningAIPlayer::OutputToMove(unsigned long output) {
+		return Point::FromMoveIndex(static_cast<int>(output), OUTPUT_VECTOR_SIZE - 1).ToGrid2(EXPECTED_BOARD_SIZE);
+	}
+
 	std::array<double, DeepLearningAIPlayer::OUTPUT_VECTOR_SIZE> DeepLearningAIPlayer::GetAllHeuristicValues() const {
 		return _heuristicValues;
 	}
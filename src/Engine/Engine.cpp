@@ -17,6 +17,7 @@ namespace BeitaGo {
 		delete _player1;
 		_player1 = nullptr;
 		delete _player2;
+		_player2 = nullptr;
 	}
 
 	void Engine::NewGame(const Grid2& boardDimensions, Player* player1, Player* player2) {
@@ -67,4 +68,11 @@ namespace BeitaGo {
 	const Player& Engine::GetPlayer2() const {
 		return *_player2;
 	}
+
+	ThreadPool& Engine::GetThreadPool() const {
+		std::call_once(_threadPoolCreated, [this]() {
+			_threadPool.reset(new ThreadPool());
+		});
+		return *_threadPool;
+	}
 }
\ No newline at end of file
@@ -14,11 +14,15 @@ namespace BeitaGo {
 	MonteCarloAIPlayer::~MonteCarloAIPlayer() {}
 
 	Grid2 MonteCarloAIPlayer::MakeDecision() const {
-		MonteCarloTree tree(GetEngine().GetBoard());
 		std::chrono::high_resolution_clock::time_point endTime = std::chrono::high_resolution_clock::now() + std::chrono::duration_cast<std::chrono::seconds>(_thinkingTime);
-		tree.InitializeNodes(5);
-		tree.RunSimulations(endTime);
-		return tree.GetMostLikelyMove();
+		if (_tree) {
+			_tree->Reset(GetEngine().GetBoard());
+		} else {
+			_tree.reset(new MonteCarloTree(GetEngine().GetBoard(), GetEngine().GetThreadPool()));
+		}
+		_tree->InitializeNodes(5);
+		_tree->RunSimulations(endTime);
+		return _tree->GetMostLikelyMove();
 	}
 
 	void MonteCarloAIPlayer::SetThinkingTime(const std::chrono::duration<double>& thinkingTime) {
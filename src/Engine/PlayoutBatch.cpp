@@ -0,0 +1,234 @@
+#include "PlayoutBatch.h"
+
+#include <sstream>
+#include <stdexcept>
+
+#include "Board.h"
+#include "Point.h"
+
+// GCC on x86-64 Linux can build Play twice, once for CPUs with AVX2 and once for any, and pick
+// one when the program loads, so the lanes get wide SIMD without building for this machine.
+// Everything Play calls is inlined into it, so both copies are built the same way.
+#if defined(__GNUC__) && !defined(__clang__) && defined(__x86_64__) && defined(__linux__)
+#define BEITAGO_PLAYOUT_CLONES __attribute__((target_clones("avx2", "default")))
+#define BEITAGO_PLAYOUT_INLINE inline __attribute__((always_inline))
+#else
+#define BEITAGO_PLAYOUT_CLONES
+#define BEITAGO_PLAYOUT_INLINE inline
+#endif
+
+namespace BeitaGo {
+	PlayoutBatch::PlayoutBatch(const Board& board) {
+		Grid2 dimensions = board.GetDimensions();
+		if (dimensions.X() != SIZE || dimensions.Y() != SIZE) {
+			std::stringstream s;
+			s << "PlayoutBatch cannot be " << dimensions.X() << "x" << dimensions.Y() << ".";
+			throw std::invalid_argument(s.str());
+		}
+		Geometry geometry;
+		Bitboard black = board.GetStoneMask(Color::Black);
+		Bitboard white = board.GetStoneMask(Color::White);
+		for (int i = 0; i < Geometry::MAX_POINTS; ++i) {
+			int line = geometry.Line(i);
+			if (line == 0) {
+				continue;
+			}
+			_onBoard.Set(i);
+			if (line == 1) {
+				_edge.Set(i);
+			}
+			int point = Point::At(i % STRIDE - 1, i / STRIDE - 1, SIZE).Index();
+			if (black.Test(point)) {
+				_startBlack.Set(i);
+			} else if (white.Test(point)) {
+				_startWhite.Set(i);
+			}
+		}
+
+		_startTurn = board.GetWhoseTurn();
+		Grid2 koPoint = board.GetKoPoint();
+		if (board.IsMoveKo(koPoint, _startTurn)) {
+			_startKo.Set((koPoint.Y() + 1) * STRIDE + koPoint.X() + 1);
+		}
+		_startPasses = board.GetConsecutivePasses();
+		_komi = board.GetKomi();
+	}
+
+	double PlayoutBatch::Score(int lane) const {
+		PointSet black = Load(_black, lane);
+		PointSet white = Load(_white, lane);
+		std::pair<int, int> territory = CountTerritory(black, white, _onBoard & ~(black | white), STRIDE);
+		return white.Count() + territory.second - black.Count() - territory.first + _komi;
+	}
+
+	BasicBitboard<2> PlayoutBatch::GetStones(int lane, Color color) const {
+		return Load(color == Color::Black ? _black : _white, lane);
+	}
+
+	BEITAGO_PLAYOUT_INLINE PlayoutBatch::PointSet PlayoutBatch::Load(const LaneSets& sets, int lane) {
+		PointSet set;
+		for (int w = 0; w < WORDS; ++w) {
+			set.Word(w) = sets[w][lane];
+		}
+		return set;
+	}
+
+	BEITAGO_PLAYOUT_INLINE void PlayoutBatch::Store(LaneSets& sets, int lane, const PointSet& set) {
+		for (int w = 0; w < WORDS; ++w) {
+			sets[w][lane] = set.Word(w);
+		}
+	}
+
+	void PlayoutBatch::Run(RandomStream& random) {
+		for (int l = 0; l < LANES; ++l) {
+			_random[l] = random.Split();
+		}
+		Play();
+	}
+
+	BEITAGO_PLAYOUT_CLONES void PlayoutBatch::Play() {
+		for (int l = 0; l < LANES; ++l) {
+			Store(_black, l, _startBlack);
+			Store(_white, l, _startWhite);
+			Store(_ko, l, _startKo);
+			_passes[l] = static_cast<uint8_t>(_startPasses);
+		}
+		_whoseTurn = _startTurn;
+
+		// Playouts don't fill their own eyes, so games end on their own. The cap only stops a
+		// long ko fight, as it does for a PlayoutBoard.
+		const int maxMoves = 3 * SIZE * SIZE;
+		for (int i = 0; i < maxMoves; ++i) {
+			bool playing = false;
+			for (int l = 0; l < LANES; ++l) {
+				playing = playing || _passes[l] < 2;
+			}
+			if (!playing) {
+				break;
+			}
+			Step();
+		}
+	}
+
+	BEITAGO_PLAYOUT_INLINE void PlayoutBatch::Step() {
+		LaneSets& own = _whoseTurn == Color::Black ? _black : _white;
+		LaneSets& enemy = _whoseTurn == Color::Black ? _white : _black;
+
+		// Every lane's candidates are its empty points that aren't its own eyes or the ko point.
+		// An eye is surrounded by the player's stones and the edge, and has fewer than two enemy
+		// diagonals, or none on the edge, like BasicPlayoutBoard::IsEye.
+		alignas(64) LaneSets candidates;
+		for (int l = 0; l < LANES; ++l) {
+			PointSet o = Load(own, l);
+			PointSet e = Load(enemy, l);
+			PointSet empty = _onBoard & ~(o | e);
+			PointSet surrounded = empty & ~(_onBoard & ~o).Neighbors(STRIDE);
+			PointSet d1 = e.ShiftUp(STRIDE - 1);
+			PointSet d2 = e.ShiftUp(STRIDE + 1);
+			PointSet d3 = e.ShiftDown(STRIDE - 1);
+			PointSet d4 = e.ShiftDown(STRIDE + 1);
+			PointSet twoDiagonals = (d1 & (d2 | d3 | d4)) | (d2 & (d3 | d4)) | (d3 & d4);
+			PointSet eyes = surrounded & ~twoDiagonals & ~(_edge & (d1 | d2 | d3 | d4));
+			Store(candidates, l, empty & ~eyes & ~Load(_ko, l));
+		}
+
+		for (int l = 0; l < LANES; ++l) {
+			PointSet move;
+			int index = _passes[l] < 2 ? PickMove(l, Load(candidates, l), Load(own, l), Load(enemy, l)) : -1;
+			if (index >= 0) {
+				move.Set(index);
+				_passes[l] = 0;
+			} else if (_passes[l] < 2) {
+				++_passes[l];
+			}
+			Store(_moves, l, move);
+		}
+
+		// Place the stones, then take every enemy stone that can't reach a liberty. Enemy groups
+		// away from the new stones all still have theirs, so only ones next to them can go.
+		alignas(64) LaneSets alive;
+		for (int l = 0; l < LANES; ++l) {
+			PointSet o = Load(own, l) | Load(_moves, l);
+			PointSet e = Load(enemy, l);
+			Store(own, l, o);
+			Store(alive, l, e & (_onBoard & ~(o | e)).Neighbors(STRIDE));
+		}
+		for (bool growing = true; growing;) {
+			uint64_t grown = 0;
+			for (int l = 0; l < LANES; ++l) {
+				PointSet filled = Load(alive, l);
+				PointSet next = filled.Dilate(STRIDE) & Load(enemy, l);
+				PointSet changed = next ^ filled;
+				for (int w = 0; w < WORDS; ++w) {
+					grown |= changed.Word(w);
+				}
+				Store(alive, l, next);
+			}
+			growing = grown != 0;
+		}
+
+		// A single stone that took a single stone and is left with that point as its only
+		// liberty makes a ko.
+		for (int l = 0; l < LANES; ++l) {
+			PointSet e = Load(enemy, l);
+			PointSet remaining = Load(alive, l);
+			PointSet captured = e & ~remaining;
+			PointSet move = Load(_moves, l);
+			Store(enemy, l, remaining);
+			bool singleCapture = captured.Count() == 1;
+			bool ko = singleCapture && (move.Neighbors(STRIDE) & _onBoard & ~remaining) == captured;
+			Store(_ko, l, ko ? captured : PointSet());
+		}
+		_whoseTurn = _whoseTurn == Color::Black ? Color::White : Color::Black;
+	}
+
+	BEITAGO_PLAYOUT_INLINE int PlayoutBatch::PickMove(int lane, PointSet candidates, const PointSet& own, const PointSet& enemy) {
+		PointSet empty = _onBoard & ~(own | enemy);
+		for (int count = candidates.Count(); count > 0; --count) {
+			int n = RandomBelow(_random[lane], count);
+			int low = PopCount(candidates.Word(0));
+			int index = n < low ? SelectBit(candidates.Word(0), n) : 64 + SelectBit(candidates.Word(1), n - low);
+			PointSet point;
+			point.Set(index);
+			if ((point.Neighbors(STRIDE) & empty).Any() || IsLegalWhenFilled(index, own, enemy)) {
+				return index;
+			}
+			candidates.Reset(index);
+		}
+		return -1;
+	}
+
+	BEITAGO_PLAYOUT_INLINE bool PlayoutBatch::IsLegalWhenFilled(int index, const PointSet& own, const PointSet& enemy) const {
+		PointSet point;
+		point.Set(index);
+		PointSet neighbors = point.Neighbors(STRIDE);
+		PointSet otherLiberties = _onBoard & ~(own | enemy) & ~point;
+
+		bool captures = false;
+		(neighbors & enemy).ForEach([&](int neighbor) {
+			PointSet stone;
+			stone.Set(neighbor);
+			captures = captures || !Reaches(stone, enemy, otherLiberties);
+		});
+		// Otherwise the new stone joins every friendly group around it, so together they need
+		// another liberty.
+		return captures || Reaches(neighbors & own, own, otherLiberties);
+	}
+
+	BEITAGO_PLAYOUT_INLINE bool PlayoutBatch::Reaches(PointSet group, const PointSet& stones, const PointSet& targets) {
+		// Groups usually touch one of the targets within a step or two, so this stops as soon as
+		// one does rather than filling the whole group first.
+		while (group.Any()) {
+			PointSet grown = group.Dilate(STRIDE);
+			if ((grown & targets).Any()) {
+				return true;
+			}
+			grown &= stones;
+			if (grown == group) {
+				break;
+			}
+			group = grown;
+		}
+		return false;
+	}
+}
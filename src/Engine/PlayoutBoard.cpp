@@ -0,0 +1,494 @@
+#include "PlayoutBoard.h"
+
+#include <algorithm>
+#include <type_traits>
+
+#include "Board.h"
+#include "Point.h"
+#include "Zobrist.h"
+
+namespace BeitaGo {
+	template <typename Geometry>
+	BasicPlayoutBoard<Geometry>::BasicPlayoutBoard(const Board& board) : _geometry(board.GetDimensions()) {
+		static_assert(std::is_trivially_copyable<BasicPlayoutBoard>::value, "A PlayoutBoard must be copyable with a memcpy");
+		for (int i = 0; i < MAX_POINTS; ++i) {
+			_tiles[i] = i < _geometry.Points() && _geometry.Line(i) != 0 ? Tile::None : Tile::Edge;
+			if (_tiles[i] == Tile::None) {
+				_onBoard.Set(i);
+			}
+			_groupOf[i] = -1;
+			_nextStone[i] = -1;
+			_groupSize[i] = 0;
+			_liberties[i] = 0;
+			_emptyPosition[i] = -1;
+			_patterns[i] = 0;
+		}
+		_numEmpty = 0;
+		_blackStones = 0;
+		_whiteStones = 0;
+		_hash = 0;
+		Bitboard black = board.GetStoneMask(Color::Black);
+		Bitboard white = board.GetStoneMask(Color::White);
+		for (int i = 0; i < _geometry.Points(); ++i) {
+			if (_tiles[i] == Tile::None) {
+				Grid2 position = ToGrid2(i);
+				int point = Point::At(position.X(), position.Y(), _geometry.Width()).Index();
+				if (black.Test(point)) {
+					SetStone(i, Color::Black);
+				} else if (white.Test(point)) {
+					SetStone(i, Color::White);
+				} else {
+					AddEmpty(i);
+				}
+			}
+		}
+		BuildGroups();
+
+		// Each pattern starts from whatever is around the point, and SetTile keeps it up to date.
+		const std::array<int, 4>& neighborOffsets = _geometry.NeighborOffsets();
+		const std::array<int, 4>& diagonalOffsets = _geometry.DiagonalOffsets();
+		for (int i = 0; i < MAX_POINTS; ++i) {
+			int pattern = 0;
+			if (_tiles[i] != Tile::Edge) {
+				for (int k = 0; k < 4; ++k) {
+					pattern |= static_cast<int>(_tiles[i + neighborOffsets[k]]) << (2 * k);
+					pattern |= static_cast<int>(_tiles[i + diagonalOffsets[k]]) << (2 * k + 8);
+				}
+			}
+			_patterns[i] = static_cast<uint16_t>(pattern);
+		}
+
+		_whoseTurn = board.GetWhoseTurn();
+		if (_whoseTurn == Color::White) {
+			_hash ^= Zobrist().whiteToMove;
+		}
+		Grid2 koPoint = board.GetKoPoint();
+		_koPoint = board.IsMoveKo(koPoint, _whoseTurn) ? ToIndex(koPoint) : -1;
+		_passes = board.GetConsecutivePasses();
+		_komi = board.GetKomi();
+	}
+
+	template <typename Geometry>
+	Color BasicPlayoutBoard<Geometry>::GetWhoseTurn() const {
+		return _whoseTurn;
+	}
+
+	template <typename Geometry>
+	bool BasicPlayoutBoard<Geometry>::IsGameOver() const {
+		return _passes >= 2;
+	}
+
+	template <typename Geometry>
+	bool BasicPlayoutBoard<Geometry>::IsSettled() const {
+		// Every empty point in a settled area is next to one of its color's stones, which is far
+		// cheaper to check first.
+		if ((_onBoard & ~(_black | _white).Dilate(_geometry.Stride())).Any()) {
+			return false;
+		}
+		return (UnconditionalArea(Color::Black) | UnconditionalArea(Color::White)) == _onBoard;
+	}
+
+	template <typename Geometry>
+	Color BasicPlayoutBoard<Geometry>::GetTile(const Grid2& position) const {
+		if (position.X() < 0 || position.X() >= _geometry.Width() || position.Y() < 0 || position.Y() >= _geometry.Height()) {
+			return Color::None;
+		}
+		return static_cast<Color>(_tiles[ToIndex(position)]);
+	}
+
+	template <typename Geometry>
+	int BasicPlayoutBoard<Geometry>::GetLiberties(const Grid2& position) const {
+		if (GetTile(position) == Color::None) {
+			return -1;
+		}
+		return _liberties[_groupOf[ToIndex(position)]];
+	}
+
+	template <typename Geometry>
+	uint64_t BasicPlayoutBoard<Geometry>::GetHash() const {
+		return _hash;
+	}
+
+	template <typename Geometry>
+	int BasicPlayoutBoard<Geometry>::GetEmptyCount() const {
+		return _numEmpty;
+	}
+
+	template <typename Geometry>
+	int BasicPlayoutBoard<Geometry>::ToIndex(const Grid2& position) const {
+		return (position.Y() + 1) * _geometry.Stride() + position.X() + 1;
+	}
+
+	template <typename Geometry>
+	Grid2 BasicPlayoutBoard<Geometry>::ToGrid2(int index) const {
+		if (index == PASS_INDEX) {
+			return PASS;
+		}
+		return Grid2(index % _geometry.Stride() - 1, index / _geometry.Stride() - 1);
+	}
+
+	template <typename Geometry>
+	bool BasicPlayoutBoard<Geometry>::IsLegal(int index) const {
+		if (_tiles[index] != Tile::None || index == _koPoint) {
+			return false;
+		}
+
+		// The move is safe if it has an empty neighbour, captures an enemy group that's down to
+		// its last liberty, or joins a friendly group with a liberty to spare.
+		Tile friendly = ToTile(_whoseTurn);
+		bool safe = false;
+		ForEachNeighbor(index, [&](int neighbor) {
+			Tile tile = _tiles[neighbor];
+			if (tile == Tile::None) {
+				safe = true;
+			} else if (tile != Tile::Edge && (tile == friendly ? _liberties[_groupOf[neighbor]] > 1 : _liberties[_groupOf[neighbor]] == 1)) {
+				safe = true;
+			}
+		});
+		return safe;
+	}
+
+	template <typename Geometry>
+	bool BasicPlayoutBoard<Geometry>::IsEye(int index, Color color) const {
+		if (_tiles[index] != Tile::None) {
+			return false;
+		}
+		Tile friendly = ToTile(color);
+		bool surrounded = true;
+		ForEachNeighbor(index, [&](int neighbor) {
+			surrounded = surrounded && (_tiles[neighbor] == friendly || _tiles[neighbor] == Tile::Edge);
+		});
+		if (!surrounded) {
+			return false;
+		}
+		int enemyDiagonals = 0;
+		bool onEdge = false;
+		for (int offset : _geometry.DiagonalOffsets()) {
+			Tile tile = _tiles[index + offset];
+			if (tile == Tile::Edge) {
+				onEdge = true;
+			} else if (tile != friendly && tile != Tile::None) {
+				++enemyDiagonals;
+			}
+		}
+		return enemyDiagonals + (onEdge ? 1 : 0) < 2;
+	}
+
+	template <typename Geometry>
+	void BasicPlayoutBoard<Geometry>::Play(int index) {
+		Color color = _whoseTurn;
+		Color enemyColor = color == Color::Black ? Color::White : Color::Black;
+		_koPoint = -1;
+		_whoseTurn = enemyColor;
+		_hash ^= Zobrist().whiteToMove;
+		if (index == PASS_INDEX) {
+			++_passes;
+			return;
+		}
+		_passes = 0;
+
+		SetStone(index, color);
+		RemoveEmpty(index);
+		_groupOf[index] = index;
+		_nextStone[index] = index;
+		_groupSize[index] = 1;
+
+		// Find the distinct groups around the new stone. There can be at most four.
+		int friendlyGroups[4];
+		int numFriendlyGroups = 0;
+		int enemyGroups[4];
+		int numEnemyGroups = 0;
+		int emptyNeighbors = 0;
+		ForEachNeighbor(index, [&](int neighbor) {
+			Tile tile = _tiles[neighbor];
+			int group = _groupOf[neighbor];
+			if (tile == Tile::None) {
+				++emptyNeighbors;
+			} else if (tile == ToTile(color)) {
+				if (std::find(friendlyGroups, friendlyGroups + numFriendlyGroups, group) == friendlyGroups + numFriendlyGroups) {
+					friendlyGroups[numFriendlyGroups++] = group;
+				}
+			} else if (tile != Tile::Edge && std::find(enemyGroups, enemyGroups + numEnemyGroups, group) == enemyGroups + numEnemyGroups) {
+				enemyGroups[numEnemyGroups++] = group;
+			}
+		});
+
+		// Extending a single group only needs to look around the new stone, while joining several
+		// groups recounts the result.
+		int group = index;
+		if (numFriendlyGroups == 0) {
+			_liberties[index] = emptyNeighbors;
+		} else if (numFriendlyGroups == 1) {
+			group = friendlyGroups[0];
+			int liberties = _liberties[group] - 1;
+			ForEachNeighbor(index, [&](int neighbor) {
+				if (_tiles[neighbor] == Tile::None) {
+					bool adjacent = false;
+					ForEachNeighbor(neighbor, [&](int next) {
+						adjacent = adjacent || _groupOf[next] == group;
+					});
+					liberties += adjacent ? 0 : 1;
+				}
+			});
+			group = MergeGroups(group, index);
+			_liberties[group] = static_cast<int16_t>(liberties);
+		} else {
+			for (int i = 0; i < numFriendlyGroups; ++i) {
+				group = MergeGroups(group, friendlyGroups[i]);
+			}
+			_liberties[group] = CountLiberties(group);
+		}
+
+		int captured = 0;
+		int capturedPoint = -1;
+		for (int i = 0; i < numEnemyGroups; ++i) {
+			if (--_liberties[enemyGroups[i]] == 0) {
+				capturedPoint = enemyGroups[i];
+				captured += RemoveGroup(enemyGroups[i], enemyColor);
+			}
+		}
+
+		// A lone stone that captured a lone stone and is left in atari is a ko.
+		if (captured == 1 && _groupSize[_groupOf[index]] == 1 && _liberties[_groupOf[index]] == 1) {
+			_koPoint = capturedPoint;
+		}
+	}
+
+	template <typename Geometry>
+	double BasicPlayoutBoard<Geometry>::Score() const {
+		// This is the same bit-parallel fill as BasicBoard::ScoreArea.
+		std::pair<int, int> territory = CountTerritory(_black, _white, _onBoard & ~(_black | _white), _geometry.Stride());
+		return (_whiteStones + territory.second) - (_blackStones + territory.first) + _komi;
+	}
+
+	template <typename Geometry>
+	double BasicPlayoutBoard<Geometry>::ScoreSettled() const {
+		// Settled areas go to their color whole. Everywhere else is counted as Score does,
+		// with the settled areas bordering a region counting as their color's stones.
+		PointSet blackSettled = UnconditionalArea(Color::Black);
+		PointSet whiteSettled = UnconditionalArea(Color::White);
+		PointSet rest = _onBoard & ~(blackSettled | whiteSettled);
+		std::pair<int, int> territory = CountTerritory(blackSettled | (_black & rest), whiteSettled | (_white & rest), rest & ~(_black | _white), _geometry.Stride());
+		int blackArea = blackSettled.Count() + (_black & rest).Count() + territory.first;
+		int whiteArea = whiteSettled.Count() + (_white & rest).Count() + territory.second;
+		return whiteArea - blackArea + _komi;
+	}
+
+	template <typename Geometry>
+	typename BasicPlayoutBoard<Geometry>::PointSet BasicPlayoutBoard<Geometry>::UnconditionalArea(Color color) const {
+		int stride = _geometry.Stride();
+		const PointSet& own = color == Color::Black ? _black : _white;
+		PointSet others = _onBoard & ~own;
+		PointSet empty = others & ~(color == Color::Black ? _white : _black);
+
+		// Only the smallest regions are tried as vital ones: empty points with nothing but the
+		// color's stones and the edge around them. Each is vital to every group around it.
+		PointSet eyes = empty & ~others.Neighbors(stride);
+		int eyePoints[MAX_POINTS];
+		int numEyes = 0;
+		eyes.ForEach([&](int index) {
+			eyePoints[numEyes++] = index;
+		});
+		if (numEyes < 2) {
+			return PointSet();
+		}
+		const std::array<int, 4>& offsets = _geometry.NeighborOffsets();
+		std::array<int16_t, MAX_POINTS> eyeCount; // How many eyes each group has left. Only meaningful for representatives.
+		for (int i = 0; i < numEyes; ++i) {
+			for (int k = 0; k < 4; ++k) {
+				int neighbor = eyePoints[i] + offsets[k];
+				if (_tiles[neighbor] != Tile::Edge) {
+					eyeCount[_groupOf[neighbor]] = 0;
+				}
+			}
+		}
+		auto forEachGroup = [&](int eye, auto f) {
+			int seen[4];
+			int numSeen = 0;
+			for (int k = 0; k < 4; ++k) {
+				int neighbor = eye + offsets[k];
+				if (_tiles[neighbor] != Tile::Edge && std::find(seen, seen + numSeen, _groupOf[neighbor]) == seen + numSeen) {
+					seen[numSeen++] = _groupOf[neighbor];
+					f(seen[numSeen - 1]);
+				}
+			}
+		};
+		for (int i = 0; i < numEyes; ++i) {
+			forEachGroup(eyePoints[i], [&](int group) {
+				++eyeCount[group];
+			});
+		}
+
+		// Drop every eye next to a group with fewer than two, which can leave more groups short,
+		// until nothing changes. The groups left are alive.
+		bool changed = true;
+		while (changed) {
+			changed = false;
+			for (int i = 0; i < numEyes; ++i) {
+				bool dropped = false;
+				forEachGroup(eyePoints[i], [&](int group) {
+					dropped = dropped || eyeCount[group] < 2;
+				});
+				if (dropped) {
+					forEachGroup(eyePoints[i], [&](int group) {
+						--eyeCount[group];
+					});
+					eyePoints[i--] = eyePoints[--numEyes];
+					changed = true;
+				}
+			}
+		}
+		PointSet alive;
+		for (int i = 0; i < numEyes; ++i) {
+			forEachGroup(eyePoints[i], [&](int group) {
+				alive.Set(group);
+			});
+		}
+		if (alive.None()) {
+			return alive;
+		}
+		alive = FloodFill(alive, own, stride);
+
+		// A region belongs to the color too if every empty point in it is a liberty of an alive
+		// group and every stone around it is alive, since the other color can't make an eye in
+		// it or capture its way out.
+		PointSet unsettled = (empty & ~alive.Neighbors(stride)) | (others & (own & ~alive).Neighbors(stride));
+		return alive | (others & ~FloodFill(unsettled, others, stride));
+	}
+
+	template <typename Geometry>
+	void BasicPlayoutBoard<Geometry>::SetTile(int index, Tile tile) {
+		// A point is the opposite neighbour of each of the points around it. The neighbour
+		// offsets come in opposite pairs, and so do the diagonals, outside in.
+		static const int OPPOSITE[8] = {1, 0, 3, 2, 7, 6, 5, 4};
+		int change = static_cast<int>(_tiles[index]) ^ static_cast<int>(tile);
+		_tiles[index] = tile;
+		const std::array<int, 4>& neighborOffsets = _geometry.NeighborOffsets();
+		const std::array<int, 4>& diagonalOffsets = _geometry.DiagonalOffsets();
+		for (int k = 0; k < 4; ++k) {
+			_patterns[index + neighborOffsets[k]] ^= static_cast<uint16_t>(change << (2 * OPPOSITE[k]));
+			_patterns[index + diagonalOffsets[k]] ^= static_cast<uint16_t>(change << (2 * OPPOSITE[k + 4]));
+		}
+	}
+
+	template <typename Geometry>
+	void BasicPlayoutBoard<Geometry>::SetStone(int index, Color color) {
+		SetTile(index, ToTile(color));
+		if (color == Color::Black) {
+			_black.Set(index);
+			++_blackStones;
+		} else {
+			_white.Set(index);
+			++_whiteStones;
+		}
+		_hash ^= StoneKey(index, color);
+	}
+
+	template <typename Geometry>
+	void BasicPlayoutBoard<Geometry>::BuildGroups() {
+		for (int i = 0; i < _geometry.Points(); ++i) {
+			if ((_tiles[i] == Tile::Black || _tiles[i] == Tile::White) && _groupOf[i] == -1) {
+				_groupOf[i] = i;
+				_nextStone[i] = i;
+				_groupSize[i] = 1;
+				ForEachNeighbor(i, [&](int neighbor) {
+					if (_tiles[neighbor] == _tiles[i] && _groupOf[neighbor] != -1) {
+						MergeGroups(_groupOf[i], _groupOf[neighbor]);
+					}
+				});
+			}
+		}
+		for (int i = 0; i < _geometry.Points(); ++i) {
+			if (_groupOf[i] == i) {
+				_liberties[i] = CountLiberties(i);
+			}
+		}
+	}
+
+	template <typename Geometry>
+	int BasicPlayoutBoard<Geometry>::CountLiberties(int group) const {
+		// Liberties are marked as they're found so each is only counted once.
+		bool counted[MAX_POINTS] = {};
+		int liberties = 0;
+		int stone = group;
+		do {
+			ForEachNeighbor(stone, [&](int neighbor) {
+				if (_tiles[neighbor] == Tile::None && !counted[neighbor]) {
+					counted[neighbor] = true;
+					++liberties;
+				}
+			});
+			stone = _nextStone[stone];
+		} while (stone != group);
+		return liberties;
+	}
+
+	template <typename Geometry>
+	int BasicPlayoutBoard<Geometry>::MergeGroups(int a, int b) {
+		if (a == b) {
+			return a;
+		}
+		if (_groupSize[a] < _groupSize[b]) {
+			std::swap(a, b);
+		}
+		int stone = b;
+		do {
+			_groupOf[stone] = static_cast<int16_t>(a);
+			stone = _nextStone[stone];
+		} while (stone != b);
+		std::swap(_nextStone[a], _nextStone[b]);
+		_groupSize[a] += _groupSize[b];
+		return a;
+	}
+
+	template <typename Geometry>
+	int BasicPlayoutBoard<Geometry>::RemoveGroup(int group, Color color) {
+		int removed = _groupSize[group];
+		PointSet& stones = color == Color::Black ? _black : _white;
+		int stone = group;
+		do {
+			int next = _nextStone[stone];
+			SetTile(stone, Tile::None);
+			stones.Reset(stone);
+			AddEmpty(stone);
+			_hash ^= StoneKey(stone, color);
+			_groupOf[stone] = -1;
+			_nextStone[stone] = -1;
+
+			// The emptied point becomes a liberty of each distinct group around it.
+			int counted[4];
+			int numCounted = 0;
+			ForEachNeighbor(stone, [&](int neighbor) {
+				int neighborGroup = _groupOf[neighbor];
+				if (neighborGroup != -1 && neighborGroup != group && std::find(counted, counted + numCounted, neighborGroup) == counted + numCounted) {
+					counted[numCounted++] = neighborGroup;
+					++_liberties[neighborGroup];
+				}
+			});
+			stone = next;
+		} while (stone != group);
+		(color == Color::Black ? _blackStones : _whiteStones) -= removed;
+		_groupSize[group] = 0;
+		_liberties[group] = 0;
+		return removed;
+	}
+
+	template <typename Geometry>
+	void BasicPlayoutBoard<Geometry>::AddEmpty(int index) {
+		_emptyPosition[index] = static_cast<int16_t>(_numEmpty);
+		_emptyPoints[_numEmpty++] = static_cast<int16_t>(index);
+	}
+
+	template <typename Geometry>
+	void BasicPlayoutBoard<Geometry>::RemoveEmpty(int index) {
+		int last = _emptyPoints[--_numEmpty];
+		_emptyPoints[_emptyPosition[index]] = static_cast<int16_t>(last);
+		_emptyPosition[last] = _emptyPosition[index];
+		_emptyPosition[index] = -1;
+	}
+
+	template class BasicPlayoutBoard<FixedGeometry<9>>;
+	template class BasicPlayoutBoard<FixedGeometry<13>>;
+	template class BasicPlayoutBoard<FixedGeometry<19>>;
+	template class BasicPlayoutBoard<DynamicGeometry>;
+}
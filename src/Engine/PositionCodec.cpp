@@ -0,0 +1,138 @@
+#include "PositionCodec.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#include "Point.h"
+
+namespace BeitaGo {
+	namespace {
+		const uint8_t FORMAT_VERSION = 1;
+		const uint16_t NO_POINT = 0xFFFF;
+		const uint16_t PASS_POINT = 0x7FFF;
+		const uint16_t WHITE_MOVE = 0x8000;
+
+		void PutShort(std::vector<uint8_t>& data, uint16_t value) {
+			data.push_back(static_cast<uint8_t>(value & 0xFF));
+			data.push_back(static_cast<uint8_t>(value >> 8));
+		}
+
+		/**
+		 * Reads through packed data, throwing if it runs out.
+		 */
+		class Reader {
+			public:
+			Reader(const uint8_t* data, size_t size) : _data(data), _size(size), _offset(0) {}
+
+			uint8_t Byte() {
+				if (_offset >= _size) {
+					throw std::invalid_argument("Packed position is cut short.");
+				}
+				return _data[_offset++];
+			}
+
+			uint16_t Short() {
+				uint16_t low = Byte();
+				return static_cast<uint16_t>(low | (Byte() << 8));
+			}
+
+			private:
+			const uint8_t* _data;
+			size_t _size;
+			size_t _offset;
+		};
+	}
+
+	std::vector<uint8_t> PackPosition(const Board& board, int historyMoves) {
+		Grid2 dimensions = board.GetDimensions();
+		int width = dimensions.X();
+		int points = width * dimensions.Y();
+		std::vector<MoveHistoryEntry> history = board.GetHistory();
+		int numMoves = std::min(std::min(historyMoves, static_cast<int>(history.size())), 255);
+
+		std::vector<uint8_t> data;
+		data.reserve(16 + 2 * numMoves + (points + 3) / 4);
+		data.push_back(FORMAT_VERSION);
+		data.push_back(static_cast<uint8_t>(width));
+		data.push_back(static_cast<uint8_t>(dimensions.Y()));
+		data.push_back(static_cast<uint8_t>(board.GetWhoseTurn()));
+		PutShort(data, static_cast<uint16_t>(board.GetTurnCount()));
+		Grid2 koPoint = board.GetKoPoint();
+		PutShort(data, koPoint == PASS ? NO_POINT : static_cast<uint16_t>(Point::FromGrid2(koPoint, width).Index()));
+		PutShort(data, static_cast<uint16_t>(board.GetBlackPiecesTaken()));
+		PutShort(data, static_cast<uint16_t>(board.GetWhitePiecesTaken()));
+		PutShort(data, static_cast<uint16_t>(static_cast<int16_t>(std::lround(board.GetKomi() * 2.0))));
+
+		data.push_back(static_cast<uint8_t>(numMoves));
+		for (auto it = history.end() - numMoves; it != history.end(); ++it) {
+			const Grid2& position = it->GetPosition();
+			uint16_t move = position == PASS ? PASS_POINT : static_cast<uint16_t>(Point::FromGrid2(position, width).Index());
+			PutShort(data, it->GetColor() == Color::White ? move | WHITE_MOVE : move);
+		}
+
+		size_t stonesBegin = data.size();
+		data.resize(stonesBegin + (points + 3) / 4, 0);
+		for (int p = 0; p < points; ++p) {
+			data[stonesBegin + p / 4] |= static_cast<uint8_t>(static_cast<int>(board.GetTile(Point(p).ToGrid2(width))) << (2 * (p % 4)));
+		}
+		return data;
+	}
+
+	Board UnpackPosition(const uint8_t* data, size_t size) {
+		Reader reader(data, size);
+		if (reader.Byte() != FORMAT_VERSION) {
+			throw std::invalid_argument("Packed position has an unknown format version.");
+		}
+		int width = reader.Byte();
+		int height = reader.Byte();
+		Color whoseTurn = static_cast<Color>(reader.Byte());
+		if (whoseTurn != Color::Black && whoseTurn != Color::White) {
+			throw std::invalid_argument("Packed position has nobody to move.");
+		}
+		Board board(Grid2(width, height));
+		int points = width * height;
+		auto toGrid2 = [&](uint16_t point) {
+			if (point >= points) {
+				throw std::invalid_argument("Packed position has a point off the board.");
+			}
+			return Point(point).ToGrid2(width);
+		};
+
+		int turnCount = reader.Short();
+		uint16_t ko = reader.Short();
+		Grid2 koPoint = ko == NO_POINT ? PASS : toGrid2(ko);
+		int blackPiecesTaken = reader.Short();
+		int whitePiecesTaken = reader.Short();
+		board.SetKomi(static_cast<int16_t>(reader.Short()) / 2.0);
+
+		std::vector<MoveHistoryEntry> recentMoves;
+		int numMoves = reader.Byte();
+		recentMoves.reserve(numMoves);
+		for (int i = 0; i < numMoves; ++i) {
+			uint16_t move = reader.Short();
+			uint16_t point = move & ~WHITE_MOVE;
+			recentMoves.emplace_back(point == PASS_POINT ? PASS : toGrid2(point), (move & WHITE_MOVE) ? Color::White : Color::Black);
+		}
+
+		std::vector<std::vector<Color>> layout(width, std::vector<Color>(height, Color::None));
+		uint8_t bits = 0;
+		for (int p = 0; p < points; ++p) {
+			if (p % 4 == 0) {
+				bits = reader.Byte();
+			}
+			Color color = static_cast<Color>((bits >> (2 * (p % 4))) & 3);
+			if (color != Color::None && color != Color::Black && color != Color::White) {
+				throw std::invalid_argument("Packed position has an unknown stone.");
+			}
+			layout[Point(p).X(width)][Point(p).Y(width)] = color;
+		}
+
+		board.LoadPosition(layout, whoseTurn, turnCount, koPoint, blackPiecesTaken, whitePiecesTaken, recentMoves);
+		return board;
+	}
+
+	Board UnpackPosition(const std::vector<uint8_t>& data) {
+		return UnpackPosition(data.data(), data.size());
+	}
+}
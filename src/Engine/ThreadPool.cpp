@@ -0,0 +1,147 @@
+#include "ThreadPool.h"
+
+#include <algorithm>
+
+namespace BeitaGo {
+	namespace {
+		// Which pool's worker this thread is, so tasks added from a worker go on its own queue.
+		thread_local const ThreadPool* currentPool = nullptr;
+		thread_local int currentWorker = -1;
+	}
+
+	ThreadPool::ThreadPool(int threads) : _queued(0), _nextQueue(0), _stopping(false) {
+		threads = std::max(threads, 1);
+		for (int i = 0; i < threads; ++i) {
+			_queues.emplace_back(new Queue());
+		}
+		for (int i = 0; i < threads; ++i) {
+			_workers.emplace_back([this, i]() { WorkerLoop(i); });
+		}
+	}
+
+	ThreadPool::~ThreadPool() {
+		{
+			std::lock_guard<std::mutex> guard(_sleepLock);
+			_stopping = true;
+		}
+		_wake.notify_all();
+		for (std::thread& worker : _workers) {
+			worker.join();
+		}
+	}
+
+	int ThreadPool::Size() const {
+		// The queues are all there before any worker starts, unlike the workers themselves.
+		return static_cast<int>(_queues.size());
+	}
+
+	void ThreadPool::ParallelFor(int count, const std::function<void(int)>& task) {
+		if (count <= 0) {
+			return;
+		}
+		Job job;
+		job.task = &task;
+		job.remaining = count;
+
+		// A worker keeps its own tasks, since it's about to wait on them anyway. Anyone else
+		// deals them out over every queue, starting from a different one each time.
+		int size = Size();
+		int home = CurrentWorker();
+		if (home >= 0) {
+			std::lock_guard<std::mutex> guard(_queues[home]->lock);
+			for (int i = 0; i < count; ++i) {
+				_queues[home]->tasks.push_back(Task{&job, i});
+			}
+		} else {
+			home = static_cast<int>(_nextQueue.fetch_add(1, std::memory_order_relaxed) % size);
+			for (int q = 0; q < std::min(count, size); ++q) {
+				Queue& queue = *_queues[(home + q) % size];
+				std::lock_guard<std::mutex> guard(queue.lock);
+				for (int i = q; i < count; i += size) {
+					queue.tasks.push_back(Task{&job, i});
+				}
+			}
+		}
+		_queued.fetch_add(count);
+		{
+			std::lock_guard<std::mutex> guard(_sleepLock);
+		}
+		_wake.notify_all();
+
+		// Help out until there's nothing left to take. Every task of this job was queued
+		// before that, so the rest are already running and only need waiting for.
+		while (job.remaining.load(std::memory_order_acquire) > 0 && RunOne(home)) {}
+		std::unique_lock<std::mutex> lock(job.lock);
+		job.done.wait(lock, [&job]() { return job.remaining.load(std::memory_order_acquire) == 0; });
+		if (job.error) {
+			std::rethrow_exception(job.error);
+		}
+	}
+
+	int ThreadPool::DefaultThreadCount() {
+		return std::max(static_cast<int>(std::thread::hardware_concurrency()), 1);
+	}
+
+	void ThreadPool::WorkerLoop(int worker) {
+		currentPool = this;
+		currentWorker = worker;
+		while (true) {
+			if (RunOne(worker)) {
+				continue;
+			}
+			std::unique_lock<std::mutex> lock(_sleepLock);
+			_wake.wait(lock, [this]() { return _stopping || _queued.load() > 0; });
+			if (_stopping && _queued.load() == 0) {
+				return;
+			}
+		}
+	}
+
+	bool ThreadPool::RunOne(int queue) {
+		Task task{nullptr, 0};
+		int size = Size();
+		for (int i = 0; i < size && task.job == nullptr; ++i) {
+			Queue& q = *_queues[(queue + i) % size];
+			std::lock_guard<std::mutex> guard(q.lock);
+			if (q.tasks.empty()) {
+				continue;
+			}
+			if (i == 0) {
+				task = q.tasks.back();
+				q.tasks.pop_back();
+			} else {
+				task = q.tasks.front();
+				q.tasks.pop_front();
+			}
+		}
+		if (task.job == nullptr) {
+			return false;
+		}
+		_queued.fetch_sub(1);
+
+		// An exception can't leave here, since on a worker that would end the process, and on a
+		// caller it would free the job while its other tasks still point at it.
+		std::exception_ptr error;
+		try {
+			(*task.job->task)(task.index);
+		} catch (...) {
+			error = std::current_exception();
+		}
+
+		// The job lives on its caller's stack, so once the last task is done nothing may touch
+		// it but the caller.
+		Job& job = *task.job;
+		std::lock_guard<std::mutex> guard(job.lock);
+		if (error && !job.error) {
+			job.error = error;
+		}
+		if (job.remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+			job.done.notify_all();
+		}
+		return true;
+	}
+
+	int ThreadPool::CurrentWorker() const {
+		return currentPool == this ? currentWorker : -1;
+	}
+}
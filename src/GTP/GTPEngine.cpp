@@ -255,8 +255,9 @@ void GTPEngine::GenMove(int id, const std::vector<std::string>& arguments) {
 }
 
 void GTPEngine::Undo(int id, const std::vector<std::string>& arguments) {
-	if (_engine.GetBoard().GetTurnCount() > 1) {
-		_engine.GetBoard().RewindBoard(1);
+	// A loaded position keeps its recent moves in the history, but they can't be undone.
+	if (_engine.GetBoard().CanUndo()) {
+		_engine.GetBoard().UndoMove();
 		PrintSuccessResponse(id, "");
 	} else {
 		PrintFailureResponse(id, "cannot undo");
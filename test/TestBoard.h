@@ -0,0 +1,1106 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <iterator>
+#include <random>
+
+#include "BasicBoard.h"
+#include "Board.h"
+#include "Constants.h"
+#include "PlayoutBatch.h"
+#include "PlayoutBoard.h"
+#include "Point.h"
+#include "PositionCodec.h"
+
+using namespace BeitaGo;
+
+TEST(BoardTest, DimensionsTest) {
+	ASSERT_THROW(Board(Grid2(0, 9)), std::invalid_argument);
+	ASSERT_THROW(Board(Grid2(9, MAX_BOARD_SIZE + 1)), std::invalid_argument);
+
+	Board b(Grid2(7, 4));
+	ASSERT_EQ(b.GetDimensions(), Grid2(7, 4));
+	ASSERT_EQ(b.GetTile(Grid2(-1, 0)), Color::None);
+	ASSERT_EQ(b.GetTile(Grid2(7, 0)), Color::None);
+	ASSERT_EQ(b.GetTile(Grid2(0, 4)), Color::None);
+	ASSERT_EQ(b.GetValidMoves(Color::Black).size(), 7 * 4 + 1);
+}
+
+TEST(BoardTest, LibertiesTest) {
+	Board b(Grid2(9, 9));
+	b.PlacePiece(Grid2(0, 0), Color::Black);
+	ASSERT_EQ(b.GetLiberties(Grid2(0, 0)), 2);
+	b.PlacePiece(Grid2(8, 4), Color::Black);
+	ASSERT_EQ(b.GetLiberties(Grid2(8, 4)), 3);
+	b.PlacePiece(Grid2(4, 4), Color::Black);
+	ASSERT_EQ(b.GetLiberties(Grid2(4, 4)), 4);
+	b.PlacePiece(Grid2(4, 5), Color::Black);
+	ASSERT_EQ(b.GetLiberties(Grid2(4, 4)), 6);
+	ASSERT_EQ(b.GetGroup(Grid2(4, 5)).size(), 2);
+	b.PlacePiece(Grid2(5, 4), Color::White);
+	ASSERT_EQ(b.GetLiberties(Grid2(4, 4)), 5);
+	ASSERT_EQ(b.GetLiberties(Grid2(5, 4)), 3);
+	ASSERT_EQ(b.GetLiberties(Grid2(3, 3)), -1);
+	ASSERT_TRUE(b.GetGroup(Grid2(3, 3)).empty());
+}
+
+TEST(BoardTest, EdgeCaptureTest) {
+	// Stones on the right edge must not see stones on the left edge of the next row.
+	Board b(Grid2(5, 5));
+	b.PlacePiece(Grid2(4, 0), Color::White);
+	b.PlacePiece(Grid2(0, 1), Color::White);
+	b.PlacePiece(Grid2(3, 0), Color::Black);
+	ASSERT_EQ(b.GetLiberties(Grid2(4, 0)), 1);
+	b.PlacePiece(Grid2(4, 1), Color::Black);
+	ASSERT_EQ(b.GetTile(Grid2(4, 0)), Color::None);
+	ASSERT_EQ(b.GetTile(Grid2(0, 1)), Color::White);
+	ASSERT_EQ(b.GetBlackPiecesTaken(), 1);
+	ASSERT_EQ(b.GetWhitePiecesTaken(), 0);
+}
+
+TEST(BoardTest, SuicideTest) {
+	Board b(Grid2(5, 5));
+	b.PlacePiece(Grid2(1, 0), Color::Black);
+	b.PlacePiece(Grid2(0, 1), Color::Black);
+	ASSERT_TRUE(b.IsMoveSuicidePlay(Grid2(0, 0), Color::White));
+	ASSERT_FALSE(b.IsMoveValid(Grid2(0, 0), Color::White));
+	ASSERT_TRUE(b.IsMoveValid(Grid2(0, 0), Color::Black));
+	ASSERT_THROW(b.PlacePiece(Grid2(0, 0), Color::White), std::runtime_error);
+
+	// Filling your own group's last liberty is suicide too.
+	Board c(Grid2(5, 5));
+	c.PlacePiece(Grid2(0, 0), Color::Black);
+	c.PlacePiece(Grid2(1, 0), Color::Black);
+	c.PlacePiece(Grid2(2, 0), Color::White);
+	c.PlacePiece(Grid2(1, 1), Color::White);
+	c.PlacePiece(Grid2(0, 2), Color::White);
+	ASSERT_FALSE(c.IsMoveValid(Grid2(0, 1), Color::Black));
+	ASSERT_TRUE(c.IsMoveValid(Grid2(0, 1), Color::White));
+}
+
+TEST(BoardTest, OffBoardMoveTest) {
+	// Passing and points off the board are never ko, superko, suicide or an eye.
+	Board b(Grid2(5, 5));
+	b.PlacePiece(Grid2(1, 0), Color::Black);
+	b.PlacePiece(Grid2(0, 1), Color::Black);
+	b.PlacePiece(Grid2(2, 0), Color::White);
+	b.PlacePiece(Grid2(1, 1), Color::White);
+	b.PlacePiece(Grid2(0, 2), Color::White);
+	b.PlacePiece(Grid2(0, 0), Color::White);
+	const Grid2 positions[] = {PASS, Grid2(-1, 0), Grid2(0, -1), Grid2(5, 0), Grid2(0, 5), Grid2(-100, 100), Grid2(5, 5)};
+	for (const Grid2& position : positions) {
+		for (Color color : {Color::Black, Color::White}) {
+			ASSERT_FALSE(b.IsMoveKo(position, color));
+			ASSERT_FALSE(b.IsMoveSuperko(position, color));
+			ASSERT_FALSE(b.IsMoveSuicidePlay(position, color));
+			ASSERT_FALSE(b.IsEye(position, color));
+		}
+	}
+}
+
+TEST(BoardTest, CaptureIsNotSuicideTest) {
+	Board b(Grid2(5, 5));
+	b.PlacePiece(Grid2(1, 0), Color::Black);
+	b.PlacePiece(Grid2(0, 1), Color::Black);
+	b.PlacePiece(Grid2(2, 0), Color::White);
+	b.PlacePiece(Grid2(1, 1), Color::White);
+	b.PlacePiece(Grid2(0, 2), Color::White);
+	ASSERT_TRUE(b.IsMoveValid(Grid2(0, 0), Color::White));
+	b.PlacePiece(Grid2(0, 0), Color::White);
+	ASSERT_EQ(b.GetTile(Grid2(1, 0)), Color::None);
+	ASSERT_EQ(b.GetTile(Grid2(0, 1)), Color::None);
+	ASSERT_EQ(b.GetWhitePiecesTaken(), 2);
+	ASSERT_EQ(b.GetLiberties(Grid2(0, 0)), 2);
+}
+
+TEST(BoardTest, RandomGameConsistencyTest) {
+	// Plays random games and checks every group against a simple count from the tiles.
+	std::mt19937 rand(1234);
+	for (int game = 0; game < 20; ++game) {
+		Board b(Grid2(9, 9));
+		for (int turn = 0; turn < 200 && !b.IsGameOver(); ++turn) {
+			std::vector<Grid2> validMoves = b.GetValidMoves(b.GetWhoseTurn());
+			std::uniform_int_distribution<int> distribution(0, static_cast<int>(validMoves.size()) - 1);
+			b.PlacePiece(validMoves[distribution(rand)], b.GetWhoseTurn());
+			b.NextTurn();
+
+			for (int y = 0; y < 9; ++y) {
+				for (int x = 0; x < 9; ++x) {
+					Color color = b.GetTile(Grid2(x, y));
+					if (color == Color::None) {
+						continue;
+					}
+					std::vector<Grid2> group = b.GetGroup(Grid2(x, y));
+					ASSERT_NE(std::find(group.begin(), group.end(), Grid2(x, y)), group.end());
+					std::vector<Grid2> liberties;
+					for (const Grid2& g : group) {
+						ASSERT_EQ(b.GetTile(g), color);
+						const Grid2 offsets[] = {Grid2(1, 0), Grid2(-1, 0), Grid2(0, 1), Grid2(0, -1)};
+						for (const Grid2& offset : offsets) {
+							Grid2 n = g + offset;
+							if (b.IsWithinBoard(n) && b.GetTile(n) == Color::None && std::find(liberties.begin(), liberties.end(), n) == liberties.end()) {
+								liberties.push_back(n);
+							}
+						}
+					}
+					ASSERT_GT(liberties.size(), 0);
+					ASSERT_EQ(b.GetLiberties(Grid2(x, y)), static_cast<int>(liberties.size()));
+				}
+			}
+		}
+	}
+}
+
+TEST(BoardTest, KoTest) {
+	Board b(Grid2(5, 5));
+	b.PlacePiece(Grid2(1, 0), Color::Black);
+	b.PlacePiece(Grid2(0, 1), Color::Black);
+	b.PlacePiece(Grid2(1, 2), Color::Black);
+	b.PlacePiece(Grid2(2, 0), Color::White);
+	b.PlacePiece(Grid2(3, 1), Color::White);
+	b.PlacePiece(Grid2(2, 2), Color::White);
+	b.PlacePiece(Grid2(1, 1), Color::White);
+	ASSERT_EQ(b.GetKoPoint(), PASS);
+
+	b.PlacePiece(Grid2(2, 1), Color::Black);
+	ASSERT_EQ(b.GetTile(Grid2(1, 1)), Color::None);
+	ASSERT_EQ(b.GetKoPoint(), Grid2(1, 1));
+	ASSERT_TRUE(b.IsMoveKo(Grid2(1, 1), Color::White));
+	ASSERT_TRUE(b.IsMoveSuperko(Grid2(1, 1), Color::White));
+	ASSERT_FALSE(b.IsMoveValid(Grid2(1, 1), Color::White));
+	for (const Grid2& g : b.GetValidMoves(Color::White)) {
+		ASSERT_NE(g, Grid2(1, 1));
+	}
+
+	// Once both players have played elsewhere, the ko can be taken back.
+	b.PlacePiece(Grid2(4, 4), Color::White);
+	ASSERT_EQ(b.GetKoPoint(), PASS);
+	b.PlacePiece(Grid2(4, 3), Color::Black);
+	ASSERT_TRUE(b.IsMoveValid(Grid2(1, 1), Color::White));
+	b.PlacePiece(Grid2(1, 1), Color::White);
+	ASSERT_EQ(b.GetTile(Grid2(2, 1)), Color::None);
+	ASSERT_EQ(b.GetKoPoint(), Grid2(2, 1));
+	ASSERT_FALSE(b.IsMoveValid(Grid2(2, 1), Color::Black));
+}
+
+TEST(BoardTest, HashTest) {
+	Board a(Grid2(9, 9));
+	Board b(Grid2(9, 9));
+	ASSERT_EQ(a.GetHash(), b.GetHash());
+
+	a.PlacePiece(Grid2(2, 2), Color::Black);
+	a.NextTurn();
+	a.PlacePiece(Grid2(6, 6), Color::White);
+	a.NextTurn();
+	a.PlacePiece(Grid2(2, 6), Color::Black);
+	a.NextTurn();
+
+	b.PlacePiece(Grid2(2, 6), Color::Black);
+	b.NextTurn();
+	b.PlacePiece(Grid2(6, 6), Color::White);
+	b.NextTurn();
+	ASSERT_NE(a.GetPositionHash(), b.GetPositionHash());
+	b.PlacePiece(Grid2(2, 2), Color::Black);
+	ASSERT_EQ(a.GetPositionHash(), b.GetPositionHash());
+	ASSERT_NE(a.GetHash(), b.GetHash());
+	b.NextTurn();
+	ASSERT_EQ(a.GetHash(), b.GetHash());
+
+	// Capturing a stone takes its key back out of the hash.
+	Board c(Grid2(9, 9));
+	c.PlacePiece(Grid2(6, 6), Color::White);
+	uint64_t loneWhite = c.GetPositionHash();
+	c.PlacePiece(Grid2(0, 0), Color::White);
+	c.PlacePiece(Grid2(1, 0), Color::Black);
+	ASSERT_NE(c.GetPositionHash(), loneWhite);
+	c.PlacePiece(Grid2(0, 1), Color::Black);
+	ASSERT_EQ(c.GetTile(Grid2(0, 0)), Color::None);
+
+	Board d(Grid2(9, 9));
+	d.PlacePiece(Grid2(6, 6), Color::White);
+	d.PlacePiece(Grid2(1, 0), Color::Black);
+	d.PlacePiece(Grid2(0, 1), Color::Black);
+	ASSERT_EQ(c.GetPositionHash(), d.GetPositionHash());
+	ASSERT_NE(c.GetPositionHash(), loneWhite);
+}
+
+TEST(BoardTest, UndoTest) {
+	std::mt19937 random(7);
+	for (int game = 0; game < 10; ++game) {
+		Board board(Grid2(9, 9));
+		std::vector<uint64_t> hashes;
+		std::vector<std::vector<std::vector<Color>>> layouts;
+		std::vector<std::vector<std::vector<int>>> liberties;
+		std::vector<std::pair<int, int>> taken;
+		for (int turn = 0; turn < 150 && !board.IsGameOver(); ++turn) {
+			std::vector<std::vector<Color>> layout(9, std::vector<Color>(9));
+			std::vector<std::vector<int>> libs(9, std::vector<int>(9));
+			for (int x = 0; x < 9; ++x) {
+				for (int y = 0; y < 9; ++y) {
+					layout[x][y] = board.GetTile(Grid2(x, y));
+					libs[x][y] = board.GetLiberties(Grid2(x, y));
+				}
+			}
+			hashes.push_back(board.GetHash());
+			layouts.push_back(layout);
+			liberties.push_back(libs);
+			taken.emplace_back(board.GetBlackPiecesTaken(), board.GetWhitePiecesTaken());
+
+			std::vector<Grid2> moves = board.GetValidMoves(board.GetWhoseTurn());
+			board.PlacePiece(moves[random() % moves.size()], board.GetWhoseTurn());
+			board.NextTurn();
+		}
+
+		// The layout of any earlier turn can be read without undoing anything.
+		int turns = static_cast<int>(layouts.size());
+		ASSERT_EQ(board.GetPreviousLayout(turns / 2), layouts[turns - turns / 2]);
+		ASSERT_EQ(board.GetPreviousLayout(turns), layouts[0]);
+		ASSERT_EQ(board.GetPreviousState(turns / 3).GetHash(), hashes[turns - turns / 3]);
+
+		for (int turn = turns - 1; turn >= 0; --turn) {
+			board.UndoMove();
+			ASSERT_EQ(board.GetHash(), hashes[turn]);
+			ASSERT_EQ(board.GetBlackPiecesTaken(), taken[turn].first);
+			ASSERT_EQ(board.GetWhitePiecesTaken(), taken[turn].second);
+			ASSERT_EQ(board.GetTurnCount(), turn + 1);
+			for (int x = 0; x < 9; ++x) {
+				for (int y = 0; y < 9; ++y) {
+					ASSERT_EQ(board.GetTile(Grid2(x, y)), layouts[turn][x][y]);
+					ASSERT_EQ(board.GetLiberties(Grid2(x, y)), liberties[turn][x][y]);
+				}
+			}
+		}
+		ASSERT_TRUE(board.GetHistory().empty());
+		ASSERT_FALSE(board.CanUndo());
+		ASSERT_THROW(board.UndoMove(), std::runtime_error);
+	}
+}
+
+TEST(BoardTest, UndoAfterLoadTest) {
+	// The moves that led to a loaded position are in the history, but can't be undone.
+	Board board(Grid2(5, 5));
+	std::vector<std::vector<Color>> layout(5, std::vector<Color>(5, Color::None));
+	layout[1][1] = Color::Black;
+	layout[3][3] = Color::White;
+	board.LoadPosition(layout, Color::Black, 3, PASS, 0, 0, {MoveHistoryEntry(Grid2(1, 1), Color::Black), MoveHistoryEntry(Grid2(3, 3), Color::White)});
+	ASSERT_EQ(board.GetHistory().size(), 2u);
+	ASSERT_FALSE(board.CanUndo());
+	ASSERT_THROW(board.UndoMove(), std::runtime_error);
+
+	board.PlacePiece(Grid2(2, 2), Color::Black);
+	board.NextTurn();
+	ASSERT_TRUE(board.CanUndo());
+	board.UndoMove();
+	ASSERT_FALSE(board.CanUndo());
+	ASSERT_EQ(board.GetTile(Grid2(2, 2)), Color::None);
+	ASSERT_EQ(board.GetTile(Grid2(1, 1)), Color::Black);
+}
+
+TEST(BoardTest, ScoreAreaTest) {
+	Board board(Grid2(5, 5));
+	board.SetKomi(0.5);
+	ASSERT_DOUBLE_EQ(board.ScoreArea(), 0.5);
+
+	// Black walls off the left two columns, white the right two, and the middle is shared.
+	for (int y = 0; y < 5; ++y) {
+		board.PlacePiece(Grid2(1, y), Color::Black);
+		board.PlacePiece(Grid2(3, y), Color::White);
+	}
+	ASSERT_DOUBLE_EQ(board.ScoreArea(), 0.5);
+	board.PlacePiece(Grid2(4, 2), Color::White);
+	ASSERT_DOUBLE_EQ(board.ScoreArea(), 0.5);
+
+	// Once black fills the middle column, white's side is still white's alone.
+	board.PlacePiece(Grid2(2, 0), Color::Black);
+	ASSERT_DOUBLE_EQ(board.ScoreArea(), -0.5);
+	board.PlacePiece(Grid2(0, 0), Color::Black);
+	ASSERT_DOUBLE_EQ(board.ScoreArea(), -0.5);
+}
+
+TEST(BoardTest, GeometryTest) {
+	FixedGeometry<9> fixed;
+	DynamicGeometry dynamic(Grid2(9, 9));
+	ASSERT_EQ(fixed.Points(), dynamic.Points());
+	ASSERT_EQ(fixed.NeighborOffsets(), dynamic.NeighborOffsets());
+	ASSERT_EQ(fixed.DiagonalOffsets(), dynamic.DiagonalOffsets());
+	for (int i = 0; i < fixed.Points(); ++i) {
+		ASSERT_EQ(fixed.Line(i), dynamic.Line(i));
+	}
+
+	// Corners and edges are line 1, and the centre of a 9x9 is line 5.
+	ASSERT_EQ(fixed.Line(1 * 10 + 1), 1);
+	ASSERT_EQ(fixed.Line(1 * 10 + 5), 1);
+	ASSERT_EQ(fixed.Line(5 * 10 + 5), 5);
+	ASSERT_EQ(fixed.Line(0), 0);
+	ASSERT_EQ(fixed.Line(1 * 10), 0);
+	ASSERT_EQ(fixed.Line(10 * 10 + 5), 0);
+
+	ASSERT_THROW(FixedGeometry<9>(Grid2(9, 13)), std::invalid_argument);
+}
+
+TEST(BoardTest, FixedBoardTest) {
+	// A fixed board and a runtime sized one should play out the same game exactly.
+	std::mt19937 random(11);
+	FixedBoard<19> fixed;
+	BasicBoard<DynamicGeometry> dynamic(Grid2(19, 19));
+	Board board(Grid2(19, 19));
+	for (int turn = 0; turn < 400 && !fixed.IsGameOver(); ++turn) {
+		std::vector<Grid2> moves = fixed.GetValidMoves(fixed.GetWhoseTurn());
+		ASSERT_EQ(moves, dynamic.GetValidMoves(dynamic.GetWhoseTurn()));
+		Grid2 move = moves[random() % moves.size()];
+		fixed.PlacePiece(move, fixed.GetWhoseTurn());
+		dynamic.PlacePiece(move, dynamic.GetWhoseTurn());
+		board.PlacePiece(move, board.GetWhoseTurn());
+		fixed.NextTurn();
+		dynamic.NextTurn();
+		board.NextTurn();
+		ASSERT_EQ(fixed.GetHash(), dynamic.GetHash());
+		ASSERT_EQ(fixed.GetHash(), board.GetHash());
+	}
+	ASSERT_DOUBLE_EQ(fixed.ScoreArea(), dynamic.ScoreArea());
+
+	// Copies of a Board are independent of each other.
+	Board copy(board);
+	copy.UndoMove();
+	ASSERT_NE(copy.GetHash(), board.GetHash());
+	copy = board;
+	ASSERT_EQ(copy.GetHash(), board.GetHash());
+}
+
+TEST(BoardTest, RandomValidMoveTest) {
+	std::default_random_engine random(5);
+	for (int game = 0; game < 10; ++game) {
+		Board board(Grid2(9, 9));
+		for (int turn = 0; turn < 200; ++turn) {
+			std::vector<Grid2> moves = board.GetValidMoves(board.GetWhoseTurn());
+			Grid2 move = board.GetRandomValidMove(board.GetWhoseTurn(), random);
+			ASSERT_NE(std::find(moves.begin(), moves.end(), move), moves.end());
+			if (move == PASS) {
+				// Passing only comes back once nothing else is legal.
+				ASSERT_EQ(moves.size(), 1u);
+			}
+			board.PlacePiece(move, board.GetWhoseTurn());
+			board.NextTurn();
+
+			int empty = 0;
+			for (int x = 0; x < 9; ++x) {
+				for (int y = 0; y < 9; ++y) {
+					empty += board.GetTile(Grid2(x, y)) == Color::None ? 1 : 0;
+				}
+			}
+			ASSERT_EQ(board.GetEmptyCount(), empty);
+		}
+		board.RewindBoard(200);
+		ASSERT_EQ(board.GetEmptyCount(), 81);
+	}
+
+	// Every point of an empty board should come up about as often as any other.
+	Board board(Grid2(3, 3));
+	std::vector<int> counts(9, 0);
+	for (int i = 0; i < 9000; ++i) {
+		Grid2 move = board.GetRandomValidMove(Color::Black, random);
+		++counts[move.X() * 3 + move.Y()];
+	}
+	for (int count : counts) {
+		ASSERT_GT(count, 800);
+		ASSERT_LT(count, 1200);
+	}
+}
+
+TEST(BoardTest, PlayoutBoardTest) {
+	std::default_random_engine random(3);
+	Board board(Grid2(9, 9));
+	for (int turn = 0; turn < 60; ++turn) {
+		board.PlacePiece(board.GetRandomValidMove(board.GetWhoseTurn(), random), board.GetWhoseTurn());
+		board.NextTurn();
+	}
+
+	// A playout board copied out of a board agrees with it, whatever its geometry.
+	PlayoutBoard playout(board);
+	FixedPlayoutBoard<9> fixed(board);
+	ASSERT_THROW(FixedPlayoutBoard<19>{board}, std::invalid_argument);
+	ASSERT_EQ(playout.GetHash(), board.GetHash());
+	ASSERT_EQ(fixed.GetHash(), board.GetHash());
+	ASSERT_EQ(playout.GetEmptyCount(), board.GetEmptyCount());
+
+	// Playing the same moves on both keeps them in step.
+	for (int turn = 0; turn < 200 && !board.IsGameOver(); ++turn) {
+		std::vector<Grid2> moves = board.GetValidMoves(board.GetWhoseTurn());
+		Grid2 move = moves[random() % moves.size()];
+		ASSERT_TRUE(move == PASS || playout.IsLegal(playout.ToIndex(move)));
+		board.PlacePiece(move, board.GetWhoseTurn());
+		board.NextTurn();
+		playout.Play(move == PASS ? PlayoutBoard::PASS_INDEX : playout.ToIndex(move));
+		ASSERT_EQ(playout.GetHash(), board.GetHash());
+		ASSERT_EQ(playout.GetWhoseTurn(), board.GetWhoseTurn());
+		ASSERT_EQ(playout.GetEmptyCount(), board.GetEmptyCount());
+		for (int x = 0; x < 9; ++x) {
+			for (int y = 0; y < 9; ++y) {
+				ASSERT_EQ(playout.GetLiberties(Grid2(x, y)), board.GetLiberties(Grid2(x, y)));
+			}
+		}
+	}
+	ASSERT_DOUBLE_EQ(playout.Score(), board.Score());
+
+	// A playout only ever changes its own copy.
+	FixedPlayoutBoard<9> copy = fixed;
+	for (int turn = 0; turn < 200 && !copy.IsGameOver(); ++turn) {
+		copy.Play(copy.GetRandomMove(random));
+	}
+	ASSERT_NE(copy.GetHash(), fixed.GetHash());
+	ASSERT_EQ(fixed.GetHash(), PlayoutBoard(board.GetPreviousState(static_cast<int>(board.GetHistory().size()) - 60)).GetHash());
+}
+
+TEST(BoardTest, ScoreAreaRandomTest) {
+	// Area scoring by filling each empty region one point at a time, to check the board's
+	// bit-parallel version against.
+	auto reference = [](const Board& board) {
+		Grid2 size = board.GetDimensions();
+		std::vector<std::vector<bool>> seen(size.X(), std::vector<bool>(size.Y(), false));
+		int black = 0;
+		int white = 0;
+		for (int x = 0; x < size.X(); ++x) {
+			for (int y = 0; y < size.Y(); ++y) {
+				Color tile = board.GetTile(Grid2(x, y));
+				if (tile == Color::Black) {
+					++black;
+				} else if (tile == Color::White) {
+					++white;
+				} else if (!seen[x][y]) {
+					std::vector<Grid2> region(1, Grid2(x, y));
+					seen[x][y] = true;
+					bool seenBlack = false;
+					bool seenWhite = false;
+					for (size_t i = 0; i < region.size(); ++i) {
+						const Grid2 neighbors[] = {region[i] + Grid2(1, 0), region[i] + Grid2(-1, 0), region[i] + Grid2(0, 1), region[i] + Grid2(0, -1)};
+						for (const Grid2& n : neighbors) {
+							if (board.IsWithinBoard(n)) {
+								Color neighbor = board.GetTile(n);
+								seenBlack = seenBlack || neighbor == Color::Black;
+								seenWhite = seenWhite || neighbor == Color::White;
+								if (neighbor == Color::None && !seen[n.X()][n.Y()]) {
+									seen[n.X()][n.Y()] = true;
+									region.push_back(n);
+								}
+							}
+						}
+					}
+					if (seenBlack && !seenWhite) {
+						black += static_cast<int>(region.size());
+					} else if (seenWhite && !seenBlack) {
+						white += static_cast<int>(region.size());
+					}
+				}
+			}
+		}
+		return white - black + board.GetKomi();
+	};
+
+	std::default_random_engine random(9);
+	const Grid2 sizes[] = {Grid2(9, 9), Grid2(13, 13), Grid2(19, 19), Grid2(7, 11), Grid2(25, 25)};
+	for (const Grid2& size : sizes) {
+		Board board(size);
+		for (int turn = 0; turn < size.X() * size.Y() * 2 && !board.IsGameOver(); ++turn) {
+			board.PlacePiece(board.GetRandomValidMove(board.GetWhoseTurn(), random), board.GetWhoseTurn());
+			board.NextTurn();
+			if (turn % 7 == 0) {
+				ASSERT_DOUBLE_EQ(board.ScoreArea(), reference(board));
+				ASSERT_DOUBLE_EQ(PlayoutBoard(board).Score(), reference(board));
+			}
+		}
+	}
+}
+
+TEST(BoardTest, EyeTest) {
+	// .B.W.
+	// B.BW.
+	// .B.W.
+	// BB.WW
+	// .B.W.
+	Board b(Grid2(5, 5));
+	const Grid2 black[] = {Grid2(1, 0), Grid2(0, 1), Grid2(2, 1), Grid2(1, 2), Grid2(0, 3), Grid2(1, 3), Grid2(1, 4)};
+	const Grid2 white[] = {Grid2(3, 0), Grid2(3, 1), Grid2(3, 2), Grid2(3, 3), Grid2(4, 3), Grid2(3, 4)};
+	for (const Grid2& g : black) {
+		b.PlacePiece(g, Color::Black);
+	}
+	for (const Grid2& g : white) {
+		b.PlacePiece(g, Color::White);
+	}
+	ASSERT_TRUE(b.IsEye(Grid2(0, 0), Color::Black));
+	ASSERT_TRUE(b.IsEye(Grid2(1, 1), Color::Black));
+	ASSERT_TRUE(b.IsEye(Grid2(0, 2), Color::Black));
+	ASSERT_TRUE(b.IsEye(Grid2(0, 4), Color::Black));
+	ASSERT_FALSE(b.IsEye(Grid2(1, 1), Color::White));
+	ASSERT_FALSE(b.IsEye(Grid2(2, 0), Color::Black));
+	ASSERT_TRUE(b.IsEye(Grid2(4, 4), Color::White));
+	ASSERT_FALSE(b.IsEye(Grid2(4, 0), Color::White));
+	ASSERT_FALSE(b.IsEye(Grid2(1, 0), Color::Black));
+
+	// A second enemy diagonal breaks an eye in the middle, and a first one breaks it on the edge.
+	b.PlacePiece(Grid2(2, 2), Color::White);
+	ASSERT_TRUE(b.IsEye(Grid2(1, 1), Color::Black));
+	b.PlacePiece(Grid2(2, 0), Color::White);
+	ASSERT_FALSE(b.IsEye(Grid2(1, 1), Color::Black));
+	PlayoutBoard playoutEyes(b);
+	ASSERT_TRUE(playoutEyes.IsEye(playoutEyes.ToIndex(Grid2(0, 2)), Color::Black));
+	ASSERT_FALSE(playoutEyes.IsEye(playoutEyes.ToIndex(Grid2(1, 1)), Color::Black));
+	Board corner(Grid2(3, 3));
+	corner.PlacePiece(Grid2(1, 0), Color::Black);
+	corner.PlacePiece(Grid2(0, 1), Color::Black);
+	corner.PlacePiece(Grid2(1, 1), Color::White);
+	ASSERT_FALSE(corner.IsEye(Grid2(0, 0), Color::Black));
+
+	// Playouts never fill their own eyes, so they end on their own with both sides passing.
+	std::default_random_engine random(10);
+	for (int game = 0; game < 20; ++game) {
+		FixedPlayoutBoard<9> playout{Board(Grid2(9, 9))};
+		int moves = 0;
+		while (!playout.IsGameOver()) {
+			ASSERT_LT(moves++, 3 * 81);
+			int move = playout.GetRandomMove(random);
+			ASSERT_TRUE(move == PlayoutBoard::PASS_INDEX || !playout.IsEye(move, playout.GetWhoseTurn()));
+			playout.Play(move);
+		}
+	}
+}
+
+TEST(BoardTest, PatternTest) {
+	// The pattern worked out from scratch, with the same layout GetPattern uses.
+	auto reference = [](const Board& board, const Grid2& position) {
+		const Grid2 around[] = {Grid2(1, 0), Grid2(-1, 0), Grid2(0, 1), Grid2(0, -1), Grid2(1, 1), Grid2(-1, 1), Grid2(1, -1), Grid2(-1, -1)};
+		uint32_t pattern = 0;
+		for (int k = 0; k < 8; ++k) {
+			Grid2 neighbor = position + around[k];
+			uint32_t tile = board.IsWithinBoard(neighbor) ? static_cast<uint32_t>(board.GetTile(neighbor)) : 3;
+			pattern |= tile << (2 * k);
+			if (k < 4 && board.IsWithinBoard(neighbor) && board.GetLiberties(neighbor) == 1) {
+				pattern |= 1u << (PlayoutBoard::PATTERN_ATARI_SHIFT + k);
+			}
+		}
+		return pattern;
+	};
+
+	std::default_random_engine random(11);
+	const Grid2 sizes[] = {Grid2(9, 9), Grid2(7, 11)};
+	for (const Grid2& size : sizes) {
+		Board board(size);
+		for (int turn = 0; turn < 150 && !board.IsGameOver(); ++turn) {
+			board.PlacePiece(board.GetRandomValidMove(board.GetWhoseTurn(), random), board.GetWhoseTurn());
+			board.NextTurn();
+		}
+		PlayoutBoard playout(board);
+		for (int turn = 0; turn < 100 && !playout.IsGameOver(); ++turn) {
+			int move = playout.GetRandomMove(random);
+			board.PlacePiece(playout.ToGrid2(move), board.GetWhoseTurn());
+			board.NextTurn();
+			playout.Play(move);
+			for (int x = 0; x < size.X(); ++x) {
+				for (int y = 0; y < size.Y(); ++y) {
+					ASSERT_EQ(playout.GetPattern(playout.ToIndex(Grid2(x, y))), reference(board, Grid2(x, y)));
+				}
+			}
+		}
+	}
+
+	// Weighted moves only come from patterns with some weight.
+	std::vector<float> weights(PlayoutBoard::PATTERN_COUNT, 0.0f);
+	FixedPlayoutBoard<9> playout{Board(Grid2(9, 9))};
+	int corner = playout.ToIndex(Grid2(0, 0));
+	weights[playout.GetPattern(corner)] = 1.0f;
+	for (int i = 0; i < 20; ++i) {
+		ASSERT_EQ(playout.GetPattern(playout.GetWeightedMove(random, weights)), playout.GetPattern(corner));
+	}
+}
+
+TEST(BoardTest, AtariTest) {
+	// The groups in atari are the same as scanning the board for them, through captures and undos.
+	std::default_random_engine random(12);
+	Board board(Grid2(9, 9));
+	for (int turn = 0; turn < 300 && !board.IsGameOver(); ++turn) {
+		board.PlacePiece(board.GetRandomValidMove(board.GetWhoseTurn(), random), board.GetWhoseTurn());
+		board.NextTurn();
+		if (turn % 10 == 9) {
+			board.RewindBoard(3);
+		}
+		for (Color color : {Color::Black, Color::White}) {
+			std::vector<std::vector<Grid2>> expected;
+			for (int x = 0; x < 9; ++x) {
+				for (int y = 0; y < 9; ++y) {
+					std::vector<Grid2> group = board.GetGroup(Grid2(x, y));
+					if (board.GetTile(Grid2(x, y)) == color && board.GetLiberties(Grid2(x, y)) == 1 && std::find(expected.begin(), expected.end(), group) == expected.end()) {
+						expected.push_back(group);
+					}
+				}
+			}
+			std::vector<std::pair<Grid2, Grid2>> atari = board.GetAtariGroups(color);
+			ASSERT_EQ(atari.size(), expected.size());
+			for (const std::pair<Grid2, Grid2>& a : atari) {
+				ASSERT_EQ(board.GetTile(a.first), color);
+				ASSERT_EQ(board.GetLiberties(a.first), 1);
+				ASSERT_EQ(board.GetTile(a.second), Color::None);
+				bool adjacent = false;
+				for (const Grid2& stone : board.GetGroup(a.first)) {
+					Grid2 d = stone - a.second;
+					adjacent = adjacent || std::abs(d.X()) + std::abs(d.Y()) == 1;
+				}
+				ASSERT_TRUE(adjacent);
+			}
+		}
+	}
+}
+
+TEST(BoardTest, LadderTest) {
+	// A white stone that black can chase down the diagonal towards the corner.
+	Board b(Grid2(9, 9));
+	b.PlacePiece(Grid2(2, 2), Color::White);
+	b.PlacePiece(Grid2(1, 2), Color::Black);
+	b.PlacePiece(Grid2(2, 1), Color::Black);
+	b.PlacePiece(Grid2(1, 3), Color::Black);
+	uint64_t hash = b.GetHash();
+	size_t history = b.GetHistory().size();
+	ASSERT_TRUE(b.IsLadderCaptured(Grid2(2, 2)));
+	ASSERT_EQ(b.GetHash(), hash);
+	ASSERT_EQ(b.GetHistory().size(), history);
+
+	// Once in atari it still can't get away.
+	b.PlacePiece(Grid2(3, 2), Color::Black);
+	ASSERT_TRUE(b.IsLadderCaptured(Grid2(2, 2)));
+	b.UndoMove();
+
+	// A white stone in the ladder's path lets it escape.
+	b.PlacePiece(Grid2(6, 6), Color::White);
+	ASSERT_FALSE(b.IsLadderCaptured(Grid2(2, 2)));
+	ASSERT_FALSE(b.IsLadderCaptured(Grid2(6, 6)));
+	ASSERT_FALSE(b.IsLadderCaptured(Grid2(0, 0)));
+}
+
+TEST(BoardTest, LibertyUndoTest) {
+	// Liberties stay exact through captures and undos on a board sized at runtime.
+	std::default_random_engine random(13);
+	Board b(Grid2(7, 11));
+	for (int turn = 0; turn < 400 && !b.IsGameOver(); ++turn) {
+		b.PlacePiece(b.GetRandomValidMove(b.GetWhoseTurn(), random), b.GetWhoseTurn());
+		b.NextTurn();
+		if (turn % 7 == 6) {
+			b.RewindBoard(2);
+		}
+		for (int x = 0; x < 7; ++x) {
+			for (int y = 0; y < 11; ++y) {
+				if (b.GetTile(Grid2(x, y)) == Color::None) {
+					continue;
+				}
+				std::vector<Grid2> liberties;
+				for (const Grid2& g : b.GetGroup(Grid2(x, y))) {
+					const Grid2 offsets[] = {Grid2(1, 0), Grid2(-1, 0), Grid2(0, 1), Grid2(0, -1)};
+					for (const Grid2& offset : offsets) {
+						Grid2 n = g + offset;
+						if (b.IsWithinBoard(n) && b.GetTile(n) == Color::None && std::find(liberties.begin(), liberties.end(), n) == liberties.end()) {
+							liberties.push_back(n);
+						}
+					}
+				}
+				ASSERT_EQ(b.GetLiberties(Grid2(x, y)), static_cast<int>(liberties.size()));
+			}
+		}
+	}
+}
+
+TEST(BoardTest, SymmetryTest) {
+	std::default_random_engine random(14);
+	const Grid2 sizes[] = {Grid2(9, 9), Grid2(7, 11)};
+	for (const Grid2& size : sizes) {
+		for (int t = 0; t < SYMMETRY_COUNT; ++t) {
+			for (int x = 0; x < size.X(); ++x) {
+				for (int y = 0; y < size.Y(); ++y) {
+					Grid2 moved = TransformPoint(t, Grid2(x, y), size);
+					ASSERT_EQ(TransformPoint(InverseTransform(t), moved, TransformDimensions(t, size)), Grid2(x, y));
+				}
+			}
+		}
+
+		Board board(size);
+		for (int turn = 0; turn < 120; ++turn) {
+			board.PlacePiece(board.GetRandomValidMove(board.GetWhoseTurn(), random), board.GetWhoseTurn());
+			board.NextTurn();
+			if (turn % 5 == 4) {
+				board.RewindBoard(2);
+			}
+		}
+		ASSERT_EQ(board.GetSymmetryHash(0), board.GetPositionHash());
+
+		// Each symmetry hash is the hash of the board with its stones moved.
+		for (int t = 0; t < SYMMETRY_COUNT; ++t) {
+			Board moved(TransformDimensions(t, size));
+			for (int x = 0; x < size.X(); ++x) {
+				for (int y = 0; y < size.Y(); ++y) {
+					Color tile = board.GetTile(Grid2(x, y));
+					if (tile != Color::None) {
+						moved.PlacePiece(TransformPoint(t, Grid2(x, y), size), tile);
+					}
+				}
+			}
+			ASSERT_EQ(moved.GetPositionHash(), board.GetSymmetryHash(t));
+			if (IsSymmetryOf(t, size)) {
+				if (board.GetWhoseTurn() == Color::White) {
+					moved.NextTurn();
+				}
+				ASSERT_EQ(moved.GetCanonicalHash(), board.GetCanonicalHash());
+			}
+		}
+	}
+}
+
+TEST(BoardTest, PositionCodecTest) {
+	std::default_random_engine random(15);
+	const Grid2 sizes[] = {Grid2(9, 9), Grid2(19, 19), Grid2(7, 11)};
+	for (const Grid2& size : sizes) {
+		Board board(size);
+		board.SetKomi(7.5);
+		for (int turn = 0; turn < 3 * size.X() * size.Y() && !board.IsGameOver(); ++turn) {
+			board.PlacePiece(board.GetRandomValidMove(board.GetWhoseTurn(), random), board.GetWhoseTurn());
+			board.NextTurn();
+			if (turn % 13 != 0 && board.GetKoPoint() == PASS) {
+				continue;
+			}
+
+			std::vector<uint8_t> packed = PackPosition(board);
+			Board unpacked = UnpackPosition(packed);
+			ASSERT_EQ(unpacked.GetDimensions(), size);
+			ASSERT_EQ(unpacked.GetHash(), board.GetHash());
+			ASSERT_EQ(unpacked.GetCanonicalHash(), board.GetCanonicalHash());
+			ASSERT_EQ(unpacked.GetWhoseTurn(), board.GetWhoseTurn());
+			ASSERT_EQ(unpacked.GetTurnCount(), board.GetTurnCount());
+			ASSERT_EQ(unpacked.GetKoPoint(), board.GetKoPoint());
+			ASSERT_EQ(unpacked.GetBlackPiecesTaken(), board.GetBlackPiecesTaken());
+			ASSERT_EQ(unpacked.GetWhitePiecesTaken(), board.GetWhitePiecesTaken());
+			ASSERT_DOUBLE_EQ(unpacked.GetKomi(), 7.5);
+			ASSERT_DOUBLE_EQ(unpacked.ScoreArea(), board.ScoreArea());
+			ASSERT_EQ(unpacked.GetValidMoves(unpacked.GetWhoseTurn()).size(), board.GetValidMoves(board.GetWhoseTurn()).size());
+			for (int x = 0; x < size.X(); ++x) {
+				for (int y = 0; y < size.Y(); ++y) {
+					ASSERT_EQ(unpacked.GetLiberties(Grid2(x, y)), board.GetLiberties(Grid2(x, y)));
+				}
+			}
+			std::vector<MoveHistoryEntry> history = board.GetHistory();
+			std::vector<MoveHistoryEntry> recent = unpacked.GetHistory();
+			ASSERT_EQ(recent.size(), std::min(history.size(), static_cast<size_t>(PACKED_HISTORY_MOVES)));
+			for (size_t i = 1; i <= recent.size(); ++i) {
+				ASSERT_EQ(recent[recent.size() - i].GetPosition(), history[history.size() - i].GetPosition());
+				ASSERT_EQ(recent[recent.size() - i].GetColor(), history[history.size() - i].GetColor());
+			}
+		}
+		ASSERT_EQ(UnpackPosition(PackPosition(board)).IsGameOver(), board.IsGameOver());
+	}
+
+	ASSERT_LE(PackPosition(Board(Grid2(9, 9))).size(), 50u);
+	std::vector<uint8_t> packed = PackPosition(Board(Grid2(9, 9)));
+	packed.pop_back();
+	ASSERT_THROW(UnpackPosition(packed), std::invalid_argument);
+}
+
+TEST(BoardTest, SettledTest) {
+	// .BWW.
+	// BBW.W
+	// .BWWW
+	// BBWWW
+	// WBWWW
+	// .BW.W
+	// .BWW.
+	Board board(Grid2(5, 7));
+	board.SetKomi(0.5);
+	const char* rows[] = {".BWW.", "BBW.W", ".BWWW", "BBWWW", "WBWWW", ".BW.W", ".BWW."};
+	for (int y = 0; y < 7; ++y) {
+		for (int x = 0; x < 5; ++x) {
+			if (rows[y][x] != '.') {
+				board.PlacePiece(Grid2(x, y), rows[y][x] == 'B' ? Color::Black : Color::White);
+			}
+		}
+	}
+
+	// Both sides live on two single point eyes, and the white stone in the bottom left can't
+	// live, so its region is black's.
+	PlayoutBoard settled(board);
+	ASSERT_TRUE(settled.IsSettled());
+	ASSERT_DOUBLE_EQ(settled.ScoreSettled(), 21 - 14 + 0.5);
+	ASSERT_DOUBLE_EQ(settled.Score(), 22 - 11 + 0.5);
+
+	// With one eye filled, black isn't alive any more, and nothing it surrounds is settled.
+	board.PlacePiece(Grid2(0, 2), Color::Black);
+	PlayoutBoard unsettled(board);
+	ASSERT_FALSE(unsettled.IsSettled());
+	ASSERT_DOUBLE_EQ(unsettled.ScoreSettled(), unsettled.Score());
+}
+
+TEST(BoardTest, PlayOutSettledTest) {
+	// The settled position from SettledTest. Black would capture the white stone and both
+	// sides would pass if it played on to the end, but it stops at the first pass instead.
+	Board board(Grid2(5, 7));
+	board.SetKomi(0.5);
+	const char* rows[] = {".BWW.", "BBW.W", ".BWWW", "BBWWW", "WBWWW", ".BW.W", ".BWW."};
+	for (int y = 0; y < 7; ++y) {
+		for (int x = 0; x < 5; ++x) {
+			if (rows[y][x] != '.') {
+				board.PlacePiece(Grid2(x, y), rows[y][x] == 'B' ? Color::Black : Color::White);
+			}
+		}
+	}
+	RandomStream random(16);
+	PlayoutBoard playout(board);
+	ASSERT_DOUBLE_EQ(playout.PlayOut(random, 100), 21 - 14 + 0.5);
+	ASSERT_FALSE(playout.IsGameOver());
+	ASSERT_TRUE(playout.IsSettled());
+
+	// Random playouts that stop once settled score the same as playing on to two passes.
+	Board empty(Grid2(9, 9));
+	int stoppedEarly = 0;
+	for (int game = 0; game < 200; ++game) {
+		PlayoutBoard b(empty);
+		double score = b.PlayOut(random, 3 * 9 * 9);
+		if (!b.IsGameOver()) {
+			ASSERT_TRUE(b.IsSettled());
+			++stoppedEarly;
+			while (!b.IsGameOver()) {
+				b.Play(b.GetRandomMove(random));
+			}
+			ASSERT_DOUBLE_EQ(b.Score(), score);
+		}
+	}
+	ASSERT_GT(stoppedEarly, 0);
+}
+
+TEST(BoardTest, StoneMaskTest) {
+	std::default_random_engine random(19);
+	const Grid2 sizes[] = {Grid2(9, 9), Grid2(19, 19), Grid2(7, 11)};
+	for (const Grid2& size : sizes) {
+		Board board(size);
+		for (int turn = 0; turn < 2 * size.X() * size.Y() && !board.IsGameOver(); ++turn) {
+			for (Color color : {Color::Black, Color::White}) {
+				Bitboard mask = board.GetStoneMask(color);
+				for (int y = 0; y < size.Y(); ++y) {
+					for (int x = 0; x < size.X(); ++x) {
+						ASSERT_EQ(mask.Test(Point::At(x, y, size.X()).Index()), board.GetTile(Grid2(x, y)) == color);
+					}
+				}
+			}
+			// Passes now and then, so some runs of them end the history.
+			Grid2 move = random() % 8 == 0 ? PASS : board.GetRandomValidMove(board.GetWhoseTurn(), random);
+			board.PlacePiece(move, board.GetWhoseTurn());
+			board.NextTurn();
+
+			std::vector<MoveHistoryEntry> history = board.GetHistory();
+			int passes = 0;
+			for (auto it = history.rbegin(); it != history.rend() && it->GetPosition() == PASS; ++it) {
+				++passes;
+			}
+			ASSERT_EQ(board.GetConsecutivePasses(), passes);
+		}
+	}
+}
+
+TEST(BoardTest, PlayoutBoardReplayTest) {
+	// Playing moves on a playout board of an earlier position gets the same board as copying
+	// one out of the position they lead to, which is how playouts start from a tree's leaves.
+	std::default_random_engine random(20);
+	Board board(Grid2(13, 13));
+	for (int turn = 0; turn < 40; ++turn) {
+		board.PlacePiece(board.GetRandomValidMove(board.GetWhoseTurn(), random), board.GetWhoseTurn());
+		board.NextTurn();
+	}
+	PlayoutBoard root(board);
+	for (int turn = 0; turn < 300 && !board.IsGameOver(); ++turn) {
+		Grid2 move = random() % 10 == 0 ? PASS : board.GetRandomValidMove(board.GetWhoseTurn(), random);
+		board.PlacePiece(move, board.GetWhoseTurn());
+		board.NextTurn();
+		root.Play(move == PASS ? PlayoutBoard::PASS_INDEX : root.ToIndex(move));
+
+		PlayoutBoard copied(board);
+		ASSERT_EQ(root.GetHash(), copied.GetHash());
+		ASSERT_EQ(root.GetWhoseTurn(), copied.GetWhoseTurn());
+		ASSERT_EQ(root.IsGameOver(), copied.IsGameOver());
+		for (int x = 0; x < 13; ++x) {
+			for (int y = 0; y < 13; ++y) {
+				ASSERT_EQ(root.GetTile(Grid2(x, y)), copied.GetTile(Grid2(x, y)));
+				ASSERT_EQ(root.GetLiberties(Grid2(x, y)), copied.GetLiberties(Grid2(x, y)));
+				ASSERT_EQ(root.IsLegal(root.ToIndex(Grid2(x, y))), copied.IsLegal(copied.ToIndex(Grid2(x, y))));
+			}
+		}
+	}
+}
+
+TEST(BoardTest, LegalMaskTest) {
+	std::default_random_engine random(18);
+	const Grid2 sizes[] = {Grid2(9, 9), Grid2(19, 19), Grid2(7, 11), Grid2(25, 25)};
+	for (const Grid2& size : sizes) {
+		Board board(size);
+		for (int turn = 0; turn < 3 * size.X() * size.Y() && !board.IsGameOver(); ++turn) {
+			for (Color color : {Color::Black, Color::White}) {
+				Bitboard mask = board.LegalMask(color);
+				int legal = 0;
+				for (int y = 0; y < size.Y(); ++y) {
+					for (int x = 0; x < size.X(); ++x) {
+						ASSERT_EQ(mask.Test(Point::At(x, y, size.X()).Index()), board.IsMoveValid(Grid2(x, y), color));
+						legal += board.IsMoveValid(Grid2(x, y), color);
+					}
+				}
+				ASSERT_EQ(mask.Count(), legal);
+				ASSERT_EQ(static_cast<int>(board.GetValidMoves(color).size()), legal + 1);
+			}
+			board.PlacePiece(board.GetRandomValidMove(board.GetWhoseTurn(), random), board.GetWhoseTurn());
+			board.NextTurn();
+		}
+	}
+}
+
+TEST(BoardTest, FeaturePlaneTest) {
+	std::default_random_engine random(20);
+	const Grid2 sizes[] = {Grid2(9, 9), Grid2(7, 11), Grid2(19, 19)};
+	for (const Grid2& size : sizes) {
+		Board board(size);
+		for (int turn = 0; turn < 2 * size.X() * size.Y() && !board.IsGameOver(); ++turn) {
+			// Undoing now and then checks the liberty counts are put back too.
+			if (turn % 9 == 8) {
+				board.UndoMove();
+			}
+			Color color = board.GetWhoseTurn();
+			Color enemy = color == Color::Black ? Color::White : Color::Black;
+			Bitboard planes[FEATURE_PLANE_COUNT];
+			for (int i = 0; i < FEATURE_PLANE_COUNT; ++i) {
+				planes[i] = board.GetFeaturePlane(static_cast<FeaturePlane>(i));
+			}
+			ASSERT_EQ(planes[static_cast<int>(FeaturePlane::Legal)], board.LegalMask(color));
+			for (int y = 0; y < size.Y(); ++y) {
+				for (int x = 0; x < size.X(); ++x) {
+					Grid2 position(x, y);
+					int index = Point::At(x, y, size.X()).Index();
+					int liberties = board.GetLiberties(position);
+					ASSERT_EQ(planes[static_cast<int>(FeaturePlane::OneLiberty)].Test(index), liberties == 1);
+					ASSERT_EQ(planes[static_cast<int>(FeaturePlane::TwoLiberties)].Test(index), liberties == 2);
+					ASSERT_EQ(planes[static_cast<int>(FeaturePlane::ThreeOrMoreLiberties)].Test(index), liberties >= 3);
+					ASSERT_EQ(planes[static_cast<int>(FeaturePlane::Ko)].Test(index), board.GetTile(position) == Color::None && board.IsMoveKo(position, color));
+					// Counts the stones of every distinct enemy group in atari around the point.
+					std::vector<Grid2> captured;
+					for (const Grid2& offset : {Grid2(1, 0), Grid2(-1, 0), Grid2(0, 1), Grid2(0, -1)}) {
+						Grid2 neighbor = position + offset;
+						if (board.IsWithinBoard(neighbor) && board.GetTile(neighbor) == enemy && board.GetLiberties(neighbor) == 1 && std::find(captured.begin(), captured.end(), neighbor) == captured.end()) {
+							std::vector<Grid2> group = board.GetGroup(neighbor);
+							captured.insert(captured.end(), group.begin(), group.end());
+						}
+					}
+					int captures = board.GetTile(position) == Color::None ? static_cast<int>(captured.size()) : 0;
+					ASSERT_EQ(planes[static_cast<int>(FeaturePlane::CapturesOne)].Test(index), captures == 1);
+					ASSERT_EQ(planes[static_cast<int>(FeaturePlane::CapturesTwo)].Test(index), captures == 2);
+					ASSERT_EQ(planes[static_cast<int>(FeaturePlane::CapturesThreeOrMore)].Test(index), captures >= 3);
+				}
+			}
+			board.PlacePiece(board.GetRandomValidMove(color, random), color);
+			board.NextTurn();
+		}
+	}
+}
+
+TEST(BoardTest, GroupGraphTest) {
+	std::default_random_engine random(21);
+	const Grid2 sizes[] = {Grid2(9, 9), Grid2(7, 11)};
+	const Grid2 offsets[] = {Grid2(1, 0), Grid2(-1, 0), Grid2(0, 1), Grid2(0, -1)};
+	for (const Grid2& size : sizes) {
+		Board board(size);
+		// Names a group by its first stone in GetGroup order, and finds its liberties the slow way.
+		auto groupName = [&](const Grid2& position) {
+			std::vector<Grid2> group = board.GetGroup(position);
+			return Point::FromGrid2(*std::min_element(group.begin(), group.end(), [&](const Grid2& a, const Grid2& b) { return Point::FromGrid2(a, size.X()) < Point::FromGrid2(b, size.X()); }), size.X()).Index();
+		};
+		auto liberties = [&](const Grid2& position) {
+			std::vector<int> found;
+			for (const Grid2& stone : board.GetGroup(position)) {
+				for (const Grid2& offset : offsets) {
+					Grid2 neighbor = stone + offset;
+					if (board.IsWithinBoard(neighbor) && board.GetTile(neighbor) == Color::None) {
+						found.push_back(Point::FromGrid2(neighbor, size.X()).Index());
+					}
+				}
+			}
+			std::sort(found.begin(), found.end());
+			found.erase(std::unique(found.begin(), found.end()), found.end());
+			return found;
+		};
+		for (int turn = 0; turn < 2 * size.X() * size.Y() && !board.IsGameOver(); ++turn) {
+			// Undoing now and then checks groups that split apart again get their outlines back.
+			if (turn % 7 == 6) {
+				board.UndoMove();
+			}
+			for (int y = 0; y < size.Y(); ++y) {
+				for (int x = 0; x < size.X(); ++x) {
+					Grid2 position(x, y);
+					Color color = board.GetTile(position);
+					if (color == Color::None) {
+						ASSERT_TRUE(board.GetAdjacentGroups(position).empty());
+						continue;
+					}
+					std::vector<int> expected;
+					for (const Grid2& stone : board.GetGroup(position)) {
+						for (const Grid2& offset : offsets) {
+							Grid2 neighbor = stone + offset;
+							if (board.IsWithinBoard(neighbor) && board.GetTile(neighbor) != Color::None && board.GetTile(neighbor) != color) {
+								expected.push_back(groupName(neighbor));
+							}
+						}
+					}
+					std::sort(expected.begin(), expected.end());
+					expected.erase(std::unique(expected.begin(), expected.end()), expected.end());
+					std::vector<int> adjacent;
+					std::vector<int> own = liberties(position);
+					for (const Grid2& group : board.GetAdjacentGroups(position)) {
+						adjacent.push_back(groupName(group));
+						std::vector<int> theirs = liberties(group);
+						std::vector<int> shared;
+						std::set_intersection(own.begin(), own.end(), theirs.begin(), theirs.end(), std::back_inserter(shared));
+						ASSERT_EQ(board.GetSharedLiberties(position, group), static_cast<int>(shared.size()));
+					}
+					std::sort(adjacent.begin(), adjacent.end());
+					ASSERT_EQ(adjacent, expected);
+					ASSERT_EQ(board.GetSharedLiberties(position, position), static_cast<int>(own.size()));
+				}
+			}
+			board.PlacePiece(board.GetRandomValidMove(board.GetWhoseTurn(), random), board.GetWhoseTurn());
+			board.NextTurn();
+		}
+	}
+}
+
+TEST(BoardTest, PlayoutBatchTest) {
+	ASSERT_THROW(PlayoutBatch(Board(Grid2(13, 13))), std::invalid_argument);
+
+	// Each batch game has to end with no stone left without a liberty, and with nothing but
+	// single point eyes left to play in.
+	const int stride = PlayoutBatch::SIZE + 1;
+	BasicBitboard<2> onBoard;
+	for (int y = 0; y < PlayoutBatch::SIZE; ++y) {
+		for (int x = 0; x < PlayoutBatch::SIZE; ++x) {
+			onBoard.Set((y + 1) * stride + x + 1);
+		}
+	}
+	RandomStream random(7);
+	Board board(Grid2(PlayoutBatch::SIZE, PlayoutBatch::SIZE));
+	for (int position = 0; position < 4; ++position) {
+		PlayoutBatch batch(board);
+		batch.Run(random);
+		for (int l = 0; l < PlayoutBatch::LANES; ++l) {
+			BasicBitboard<2> black = batch.GetStones(l, Color::Black);
+			BasicBitboard<2> white = batch.GetStones(l, Color::White);
+			BasicBitboard<2> empty = onBoard & ~(black | white);
+			ASSERT_TRUE((black & white).None());
+			ASSERT_EQ((black | white) & ~onBoard, BasicBitboard<2>());
+			ASSERT_EQ(FloodFill(black & empty.Neighbors(stride), black, stride), black);
+			ASSERT_EQ(FloodFill(white & empty.Neighbors(stride), white, stride), white);
+			ASSERT_TRUE((empty & empty.Neighbors(stride)).None());
+			double score = batch.Score(l);
+			ASSERT_GE(score, -81 + board.GetKomi());
+			ASSERT_LE(score, 81 + board.GetKomi());
+		}
+		for (int i = 0; i < 15; ++i) {
+			board.PlacePiece(board.GetRandomValidMove(board.GetWhoseTurn(), random), board.GetWhoseTurn());
+			board.NextTurn();
+		}
+	}
+}
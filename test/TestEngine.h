@@ -1,10 +1,15 @@
 #include <gtest/gtest.h>
 
+#include <atomic>
 #include <iostream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
 
 #include "Constants.h"
 #include "Engine.h"
 #include "HumanPlayer.h"
+#include "ThreadPool.h"
 
 using namespace BeitaGo;
 
@@ -165,3 +170,88 @@ TEST(EngineTest, ScoringTest) {
 
 	ASSERT_EQ(e.GetBoard().Score(), -6.5);
 }
+
+TEST(EngineTest, ThreadPoolTest) {
+	Engine e;
+	ThreadPool& pool = e.GetThreadPool();
+	ASSERT_GE(pool.Size(), 1);
+	ASSERT_EQ(&pool, &e.GetThreadPool());
+
+	// Threads that ask for a new engine's pool at the same time all get the same one.
+	Engine fresh;
+	std::vector<ThreadPool*> pools(4, nullptr);
+	std::vector<std::thread> askers;
+	for (size_t i = 0; i < pools.size(); ++i) {
+		askers.emplace_back([&fresh, &pools, i]() { pools[i] = &fresh.GetThreadPool(); });
+	}
+	for (std::thread& asker : askers) {
+		asker.join();
+	}
+	for (ThreadPool* p : pools) {
+		ASSERT_EQ(p, pools[0]);
+	}
+
+	// Every index runs exactly once, however many there are compared to the workers.
+	for (int count : {0, 1, pool.Size(), 1000}) {
+		std::vector<std::atomic<int>> runs(count);
+		for (std::atomic<int>& r : runs) {
+			r = 0;
+		}
+		pool.ParallelFor(count, [&](int i) {
+			++runs[i];
+		});
+		for (int i = 0; i < count; ++i) {
+			ASSERT_EQ(runs[i].load(), 1);
+		}
+	}
+
+	// Tasks can wait on tasks of their own without the pool getting stuck, even if every
+	// worker is doing so at once.
+	std::atomic<int> total(0);
+	pool.ParallelFor(4 * pool.Size(), [&](int) {
+		pool.ParallelFor(10, [&](int i) {
+			total += i;
+		});
+	});
+	ASSERT_EQ(total.load(), 4 * pool.Size() * 45);
+
+	// A task that throws doesn't stop the others, and the exception comes out of ParallelFor
+	// once they're all done, even from a nested call. The pool still works afterwards.
+	for (int repeat = 0; repeat < 20; ++repeat) {
+		std::atomic<int> finished(0);
+		ASSERT_THROW(pool.ParallelFor(100, [&](int i) {
+			if (i % 7 == 3) {
+				throw std::runtime_error("task failed");
+			}
+			++finished;
+		}), std::runtime_error);
+		ASSERT_EQ(finished.load(), 100 - 14);
+	}
+	std::atomic<int> caught(0);
+	pool.ParallelFor(2 * pool.Size(), [&](int) {
+		try {
+			pool.ParallelFor(10, [&](int i) {
+				if (i == 5) {
+					throw std::logic_error("nested task failed");
+				}
+			});
+		} catch (std::logic_error&) {
+			++caught;
+		}
+	});
+	ASSERT_EQ(caught.load(), 2 * pool.Size());
+	std::atomic<int> after(0);
+	pool.ParallelFor(50, [&](int) {
+		++after;
+	});
+	ASSERT_EQ(after.load(), 50);
+
+	// A separate pool can be made with its own number of workers.
+	ThreadPool small(3);
+	ASSERT_EQ(small.Size(), 3);
+	std::atomic<int> sum(0);
+	small.ParallelFor(100, [&](int i) {
+		sum += i;
+	});
+	ASSERT_EQ(sum.load(), 4950);
+}
@@ -3,6 +3,7 @@
 #include <random>
 
 #include "Grid2.h"
+#include "Point.h"
 
 using namespace BeitaGo;
 
@@ -162,4 +163,28 @@ TEST(Grid2Test, RandomisedTest) {
 		ASSERT_EQ(g8.X(), g7.X() / r);
 		ASSERT_EQ(g8.Y(), g7.Y() / r);
 	}
-}
\ No newline at end of file
+}
+TEST(PointTest, ConversionTest) {
+	static_assert(Point::At(3, 2, 9).Index() == 21, "Points are row-major.");
+	static_assert(Point::At(3, 2, 9).X(9) == 3 && Point::At(3, 2, 9).Y(9) == 2, "Points convert back to x and y.");
+	static_assert(sizeof(Point) == 2, "Points are 16 bits.");
+
+	ASSERT_TRUE(Point().IsNone());
+	ASSERT_TRUE(Point::FromGrid2(PASS, 9).IsPass());
+	ASSERT_EQ(Point::Pass().ToGrid2(9), PASS);
+	ASSERT_NE(Point::Pass(), Point::None());
+	ASSERT_EQ(Point::Pass().MoveIndex(81), 81);
+	ASSERT_TRUE(Point::FromMoveIndex(81, 81).IsPass());
+
+	for (int width : {1, 7, 9, 19, 25}) {
+		for (int y = 0; y < 11; ++y) {
+			for (int x = 0; x < width; ++x) {
+				Point p = Point::FromGrid2(Grid2(x, y), width);
+				ASSERT_EQ(p, Point::At(x, y, width));
+				ASSERT_EQ(p.ToGrid2(width), Grid2(x, y));
+				ASSERT_EQ(p.MoveIndex(width * 11), x + y * width);
+				ASSERT_EQ(Point::FromMoveIndex(p.MoveIndex(width * 11), width * 11), p);
+			}
+		}
+	}
+}
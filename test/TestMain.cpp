@@ -1,7 +1,9 @@
 #include <gtest/gtest.h>
 
+#include "TestBoard.h"
 #include "TestEngine.h"
 #include "TestGrid2.h"
+#include "TestRandom.h"
 
 int main(int argc, char* argv[]) {
 	testing::InitGoogleTest(&argc, argv);
@@ -0,0 +1,75 @@
+#include <gtest/gtest.h>
+#include <array>
+#include <random>
+
+#include "Board.h"
+#include "PlayoutBoard.h"
+#include "RandomStream.h"
+
+using namespace BeitaGo;
+
+TEST(RandomTest, StreamTest) {
+	// The same seed and stream always give the same numbers.
+	RandomStream a(12345, 3);
+	RandomStream b(12345, 3);
+	for (int i = 0; i < 100; ++i) {
+		ASSERT_EQ(a(), b());
+	}
+
+	// Any other seed or stream doesn't.
+	RandomStream c(12345, 4);
+	RandomStream d(12346, 3);
+	int sameAsC = 0;
+	int sameAsD = 0;
+	for (int i = 0; i < 100; ++i) {
+		uint64_t x = a();
+		sameAsC += x == c();
+		sameAsD += x == d();
+	}
+	ASSERT_EQ(sameAsC, 0);
+	ASSERT_EQ(sameAsD, 0);
+}
+
+TEST(RandomTest, BelowTest) {
+	RandomStream random(42);
+	ASSERT_EQ(random.Below(1), 0u);
+	for (uint32_t n : {2u, 3u, 7u, 81u, 362u, 0x80000001u, 0xFFFFFFFFu}) {
+		for (int i = 0; i < 1000; ++i) {
+			ASSERT_LT(random.Below(n), n);
+		}
+	}
+
+	// Every number comes up about as often as the others.
+	std::array<int, 10> counts{};
+	const int draws = 100000;
+	for (int i = 0; i < draws; ++i) {
+		++counts[RandomBelow(random, 10)];
+	}
+	for (int count : counts) {
+		ASSERT_GT(count, draws / 10 * 95 / 100);
+		ASSERT_LT(count, draws / 10 * 105 / 100);
+	}
+
+	// It works anywhere a standard random engine does.
+	double d = std::uniform_real_distribution<double>(0.0, 1.0)(random);
+	ASSERT_GE(d, 0.0);
+	ASSERT_LT(d, 1.0);
+	std::default_random_engine engine;
+	int n = RandomBelow(engine, 5);
+	ASSERT_GE(n, 0);
+	ASSERT_LT(n, 5);
+}
+
+TEST(RandomTest, PlayoutTest) {
+	// A stream plays a game out to the end the same way every time.
+	Board board(Grid2(9, 9));
+	std::array<PlayoutBoard, 2> playouts{PlayoutBoard(board), PlayoutBoard(board)};
+	for (PlayoutBoard& playout : playouts) {
+		RandomStream random(7, 1);
+		for (int turn = 0; turn < 1000 && !playout.IsGameOver(); ++turn) {
+			playout.Play(playout.GetRandomMove(random));
+		}
+		ASSERT_TRUE(playout.IsGameOver());
+	}
+	ASSERT_EQ(playouts[0].Score(), playouts[1].Score());
+}